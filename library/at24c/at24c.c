@@ -0,0 +1,250 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for at24c library
+ *   (AT24Cxx TWI EEPROM)
+ * -----------------------------------------
+ */
+
+#include "at24c.h"
+
+static unsigned char at24c_pending;     // Write cycle may be in progress
+
+//  +---------------------------------------------------------------+
+//  |               AT24C end transfer                              |
+//  +---------------------------------------------------------------+
+//  | Parameter:    error       ->  Result of the transfer          |
+//  |                                                               |
+//  |    Return:    error                                           |
+//  +---------------------------------------------------------------+
+//  | STOP is only generated if the bus is owned (not after lost    |
+//  | arbitration or bus error)                                     |
+//  +---------------------------------------------------------------+
+static TWI_Error at24c_stop(TWI_Error error)
+{
+    if((error != TWI_Arbitration) && (error != TWI_Bus))
+        twi_stop();
+    
+    return error;
+}
+
+//  +---------------------------------------------------------------+
+//  |               AT24C start + address slave                     |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Memory address                  |
+//  |               operation   ->  TWI_Write/TWI_Read              |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Slave acknowledged              |
+//  |               TWI_Address ->  Slave busy or not present       |
+//  |               TWI_???     ->  Bus error (see twi.c)           |
+//  +---------------------------------------------------------------+
+//  | On an error the bus is released (STOP), also if a repeated    |
+//  | START failed or a START is still pending                      |
+//  +---------------------------------------------------------------+
+static TWI_Error at24c_select(unsigned int address, TWI_Operation operation)
+{
+    unsigned char slave = AT24C_ADDRESS;
+    
+    // Upper address bits are part of the slave address
+    #if AT24C_ADDRESS_BYTES == 1
+        slave |= 0x07 & (address>>8);
+    #endif
+    
+    TWI_Error error = twi_start();
+    
+    if(error == TWI_None)
+        error = twi_address(slave, operation);
+    
+    // Check if slave acknowledged its address
+    if((error == TWI_None) && ((twi_status() & 0xF8) != TWI_STATUS_ADDRESS_WRITE_ACK) && ((twi_status() & 0xF8) != TWI_STATUS_ADDRESS_READ_ACK))
+        error = TWI_Address;
+    
+    if(error != TWI_None)
+        return at24c_stop(error);
+    
+    return TWI_None;
+}
+
+//  +---------------------------------------------------------------+
+//  |               AT24C transmit byte                             |
+//  +---------------------------------------------------------------+
+//  | Parameter:    data        ->  Data to transmit                |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Slave acknowledged              |
+//  |               TWI_Data    ->  Slave did not acknowledge       |
+//  |               TWI_???     ->  Bus error (see twi.c)           |
+//  +---------------------------------------------------------------+
+//  | On an error the bus is released (STOP)                        |
+//  +---------------------------------------------------------------+
+static TWI_Error at24c_set(unsigned char data)
+{
+    TWI_Error error = twi_set(data);
+    
+    if((error == TWI_None) && ((twi_status() & 0xF8) != TWI_STATUS_DATA_WRITE_ACK))
+        error = TWI_Data;
+    
+    if(error != TWI_None)
+        return at24c_stop(error);
+    
+    return TWI_None;
+}
+
+//  +---------------------------------------------------------------+
+//  |               AT24C start + memory address                    |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Memory address                  |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Address set                     |
+//  |               TWI_???     ->  Error (see at24c_select())      |
+//  +---------------------------------------------------------------+
+static TWI_Error at24c_address(unsigned int address)
+{
+    TWI_Error error = at24c_select(address, TWI_Write);
+    
+    #if AT24C_ADDRESS_BYTES == 2
+        if(error == TWI_None)
+            error = at24c_set((unsigned char)(address>>8));
+    #endif
+    
+    if(error == TWI_None)
+        error = at24c_set((unsigned char)(address));
+    
+    return error;
+}
+
+//  +---------------------------------------------------------------+
+//  |               AT24C wait for write cycle                      |
+//  +---------------------------------------------------------------+
+//  |    Return:    TWI_None    ->  EEPROM ready                    |
+//  |               TWI_Address ->  No response within AT24C_POLL   |
+//  |               TWI_???     ->  Bus error (see twi.c)           |
+//  +---------------------------------------------------------------+
+//  | The EEPROM does not acknowledge its address while the write   |
+//  | cycle is in progress (ACK polling). The function returns as   |
+//  | soon as the EEPROM is ready (typically < 5 ms).               |
+//  +---------------------------------------------------------------+
+TWI_Error at24c_wait(void)
+{
+    if(!at24c_pending)
+        return TWI_None;
+    
+    for(unsigned int i=0; i < AT24C_POLL; i++)
+    {
+        TWI_Error error = at24c_select(0, TWI_Write);
+        
+        if(error == TWI_None)
+        {
+            twi_stop();
+            at24c_pending = 0;
+            return TWI_None;
+        }
+        
+        if(error != TWI_Address)
+            return error;
+    }
+    return TWI_Address;
+}
+
+//  +---------------------------------------------------------------+
+//  |               AT24C sequential read                           |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Memory address                  |
+//  |               data (ptr)  ->  Receive buffer                  |
+//  |               length      ->  Number of bytes                 |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Data read                       |
+//  |               TWI_Address ->  Range exceeds AT24C_SIZE        |
+//  |               TWI_???     ->  Error (see twi.h)               |
+//  +---------------------------------------------------------------+
+TWI_Error at24c_read(unsigned int address, unsigned char *data, unsigned int length)
+{
+    // Addresses past the end would select another slave
+    if(((unsigned long)address + length) > AT24C_SIZE)
+        return TWI_Address;
+    
+    if(length == 0)
+        return TWI_None;
+    
+    TWI_Error error = at24c_wait();
+    
+    // Dummy write sets the address counter
+    if(error == TWI_None)
+        error = at24c_address(address);
+    
+    if(error == TWI_None)
+        error = at24c_select(address, TWI_Read);
+    
+    if(error != TWI_None)
+        return error;
+    
+    // Receive data, last byte with NACK
+    while(length--)
+    {
+        error = twi_get(data++, length ? TWI_ACK : TWI_NACK);
+        
+        if(error != TWI_None)
+            break;
+    }
+    
+    return at24c_stop(error);
+}
+
+//  +---------------------------------------------------------------+
+//  |               AT24C page write                                |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Memory address                  |
+//  |               data (ptr)  ->  Transmit data                   |
+//  |               length      ->  Number of bytes                 |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Data written                    |
+//  |               TWI_Address ->  Range exceeds AT24C_SIZE        |
+//  |               TWI_???     ->  Error (see twi.h)               |
+//  +---------------------------------------------------------------+
+//  | Data is split at page borders, every page is written in one   |
+//  | transfer. Before the next page is written the EEPROM is polled|
+//  | until the write cycle is done. The function returns while the |
+//  | last page is written, the next access waits until it is done. |
+//  +---------------------------------------------------------------+
+TWI_Error at24c_write(unsigned int address, const unsigned char *data, unsigned int length)
+{
+    // Addresses past the end would select another slave
+    if(((unsigned long)address + length) > AT24C_SIZE)
+        return TWI_Address;
+    
+    while(length)
+    {
+        // Bytes until end of page
+        unsigned int size = AT24C_PAGE_SIZE - (address % AT24C_PAGE_SIZE);
+        
+        if(size > length)
+            size = length;
+        
+        TWI_Error error = at24c_wait();
+        
+        if(error == TWI_None)
+            error = at24c_address(address);
+        
+        for(unsigned int i=0; (i < size) && (error == TWI_None); i++)
+            error = at24c_set(data[i]);
+        
+        // Stop of a partial page also starts a write cycle
+        at24c_pending = 1;
+        
+        if(error != TWI_None)
+            return error;
+        
+        twi_stop();             // Start internal write cycle
+        
+        address += size;
+        data += size;
+        length -= size;
+    }
+    return TWI_None;
+}
\ No newline at end of file
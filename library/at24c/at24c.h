@@ -0,0 +1,85 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for at24c library
+ *   (AT24Cxx TWI EEPROM)
+ * -----------------------------------------
+ */
+
+#ifndef AT24C_H_
+#define AT24C_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+// Definition of AT24C parameters
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! TWI has to be initialized as master !!!
+// !!! with twi_init() in polling mode     !!!
+// !!! before the EEPROM is accessed       !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+// Device setup
+//
+// +-------------+------------+-----------+---------------+
+// | Device      | Size       | Page size | Address bytes |
+// +-------------+------------+-----------+---------------+
+// | AT24C01     | 128        | 8         | 1             |
+// | AT24C02     | 256        | 8         | 1             |
+// | AT24C04     | 512        | 16        | 1 (+1 bit)    |
+// | AT24C08     | 1024       | 16        | 1 (+2 bit)    |
+// | AT24C16     | 2048       | 16        | 1 (+3 bit)    |
+// | AT24C32     | 4096       | 32        | 2             |
+// | AT24C64     | 8192       | 32        | 2             |
+// | AT24C128    | 16384      | 64        | 2             |
+// | AT24C256    | 32768      | 64        | 2             |
+// | AT24C512    | 65536      | 128       | 2             |
+// +-------------+------------+-----------+---------------+
+//
+// AT24C04/08/16 take the upper address bits in the
+// slave address (A2:A0 pins have to be set to GND)
+
+#ifndef AT24C_ADDRESS       // Slave address of the EEPROM (A2:A0 = 0)
+    #define AT24C_ADDRESS 0x50
+#endif
+
+#ifndef AT24C_SIZE          // EEPROM size in bytes
+    #define AT24C_SIZE 256UL
+#endif
+
+#ifndef AT24C_PAGE_SIZE     // Page write size in bytes
+    #define AT24C_PAGE_SIZE 8
+#endif
+
+#ifndef AT24C_ADDRESS_BYTES // Number of memory address bytes (1/2)
+    #define AT24C_ADDRESS_BYTES 1
+#endif
+
+#ifndef AT24C_POLL          // Maximum number of ACK polls after a write (~100 us each at 100 kHz)
+    #define AT24C_POLL 100
+#endif
+
+#if (AT24C_ADDRESS_BYTES != 1) && (AT24C_ADDRESS_BYTES != 2)
+    #error "AT24C_ADDRESS_BYTES must be 1 or 2"
+#endif
+
+#include "../twi/twi.h"
+
+#ifdef TWI_TWIE
+    #error "at24c library requires TWI polling mode (TWI_TWIE not defined)"
+#endif
+
+    TWI_Error at24c_wait(void);
+    TWI_Error at24c_read(unsigned int address, unsigned char *data, unsigned int length);
+    TWI_Error at24c_write(unsigned int address, const unsigned char *data, unsigned int length);
+
+#endif /* AT24C_H_ */
\ No newline at end of file
@@ -0,0 +1,70 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for writing data blocks to an
+ *   AT24Cxx EEPROM with at24c library
+ * -----------------------------------------
+ */ 
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! Hardware setup see twi/main.c       !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// EEPROM settings
+#define EEPROM_ADDR   0x13  // EEPROM memory address (not page aligned)
+#define EEPROM_LENGTH 40    // Number of bytes (spans several pages)
+
+// System libraries
+#include <avr/io.h>
+
+// User libraries
+#include "../twi/twi.h"
+#include "at24c.h"
+
+int main(void)
+{
+    DDRC |= (1<<PC7);   // Set PIN7 as output
+    PORTC |= 0x03;      // Enable pullup resistors on SCL and SDA
+    
+    // Initialize TWI as TWI_Master
+    twi_init(TWI_Master);
+    
+    unsigned char data[EEPROM_LENGTH];
+    
+    for(unsigned char i=0; i < EEPROM_LENGTH; i++)
+        data[i] = i;
+    
+    // Write data in page bursts, the EEPROM is
+    // polled until the write cycle is finished
+    at24c_write(EEPROM_ADDR, data, EEPROM_LENGTH);
+    
+    while(1)
+    {
+        unsigned char error = 0;
+        
+        // Read data back in one sequential read
+        if(at24c_read(EEPROM_ADDR, data, EEPROM_LENGTH) != TWI_None)
+            error = 1;
+        
+        for(unsigned char i=0; i < EEPROM_LENGTH; i++)
+        {
+            if(data[i] != i)
+                error = 1;
+        }
+        
+        // Check if data written to EEPROM is same as data that was red
+        if(!error)
+            PORTC |= (1<<PC7);
+        else
+            PORTC &= ~(1<<PC7);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for button library
+ *   (parallel debouncing/button events)
+ * -----------------------------------------
+ */
+
+#include "button.h"
+
+// Vertical counter (bit n of button_ct1:button_ct0 = counter of button n)
+static unsigned char button_ct0 = 0xFF;
+static unsigned char button_ct1 = 0xFF;
+static volatile unsigned char button_debounced;     // Debounced state (1 = pressed)
+
+static unsigned char button_hold;                   // Samples until next long/repeat event
+static unsigned char button_long;                   // Long press already reported
+
+// Event queue (written by button_sample(), read by button_event())
+static volatile unsigned char button_queue[BUTTON_QUEUE_SIZE];
+static volatile unsigned char button_head;
+static volatile unsigned char button_tail;
+
+//  +---------------------------------------------------------------+
+//  |                   BUTTON read port                            |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x??        ->  Pressed buttons (1 = pressed)   |
+//  +---------------------------------------------------------------+
+static unsigned char button_raw(void)
+{
+    #ifdef BUTTON_ACTIVE_LOW
+        return ~BUTTON_PIN & BUTTON_MASK;
+    #else
+        return BUTTON_PIN & BUTTON_MASK;
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   BUTTON queue events                         |
+//  +---------------------------------------------------------------+
+//  | Parameter:    buttons     ->  Buttons with event (bit mask)   |
+//  |               type        ->  Event type                      |
+//  +---------------------------------------------------------------+
+static void button_push(unsigned char buttons, BUTTON_Type type)
+{
+    for(unsigned char button=0; buttons; button++, buttons >>= 1)
+    {
+        if(!(buttons & 0x01))
+            continue;
+        
+        unsigned char next = (button_head + 1) & (BUTTON_QUEUE_SIZE - 1);
+        
+        // Queue full -> event is lost
+        if(next == button_tail)
+            return;
+        
+        button_queue[button_head] = (unsigned char)(type<<4) | button;
+        button_head = next;     // Release entry after it is written
+    }
+}
+
+//  +---------------------------------------------------------------+
+//  |                   BUTTON initialization                       |
+//  +---------------------------------------------------------------+
+//  | Buttons that are already pressed during initialization do not |
+//  | generate a press event.                                       |
+//  +---------------------------------------------------------------+
+void button_init(void)
+{
+    BUTTON_DDR &= ~(BUTTON_MASK);   // Set buttons as input
+    
+    #ifdef BUTTON_ACTIVE_LOW
+        BUTTON_PORT |= BUTTON_MASK; // Enable pullup resistors
+    #endif
+    
+    button_ct0 = 0xFF;
+    button_ct1 = 0xFF;
+    button_debounced = button_raw();
+    
+    button_hold = BUTTON_LONG;
+    button_long = 0;
+    
+    button_tail = button_head;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   BUTTON sample                               |
+//  +---------------------------------------------------------------+
+//  | Has to be called periodically (e.g. every 10 ms from a timer  |
+//  | interrupt). A button changes its state after 4 equal samples, |
+//  | all buttons are debounced in parallel.                        |
+//  +---------------------------------------------------------------+
+void button_sample(void)
+{
+    unsigned char state = button_debounced;
+    
+    // Buttons that differ from debounced state
+    unsigned char changed = state ^ button_raw();
+    
+    // Count down changed buttons, reset all others (vertical counter)
+    button_ct0 = ~(button_ct0 & changed);
+    button_ct1 = button_ct0 ^ (button_ct1 & changed);
+    
+    // Counter of changed buttons expired -> toggle state
+    changed &= button_ct0 & button_ct1;
+    state ^= changed;
+    button_debounced = state;
+    
+    unsigned char press = changed & state;
+    
+    button_push(press, BUTTON_Press);
+    button_push(changed & ~state, BUTTON_Release);
+    
+    // Long press/repeat (hold time restarts with every new press)
+    if(!(state & BUTTON_REPEAT_MASK) || (press & BUTTON_REPEAT_MASK))
+    {
+        button_hold = BUTTON_LONG;
+        button_long = 0;
+    }
+    else if(!(--button_hold))
+    {
+        button_hold = BUTTON_REPEAT;
+        
+        button_push(state & BUTTON_REPEAT_MASK, button_long ? BUTTON_Repeat : BUTTON_Long);
+        button_long = 1;
+    }
+}
+
+//  +---------------------------------------------------------------+
+//  |                   BUTTON debounced state                      |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x??        ->  Pressed buttons (1 = pressed)   |
+//  +---------------------------------------------------------------+
+unsigned char button_state(void)
+{
+    return button_debounced;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   BUTTON get event                            |
+//  +---------------------------------------------------------------+
+//  | Parameter:    event       ->  Pointer to event                |
+//  |                                                               |
+//  |    Return:    0x00        ->  No event available              |
+//  |               0x01        ->  Event read                      |
+//  +---------------------------------------------------------------+
+//  | Never blocks, safe against button_sample() in an ISR without  |
+//  | disabling interrupts (single reader/single writer queue).     |
+//  +---------------------------------------------------------------+
+unsigned char button_event(BUTTON_Event *event)
+{
+    unsigned char tail = button_tail;
+    
+    if(tail == button_head)
+    {
+        event->type = BUTTON_None;
+        return 0x00;
+    }
+    
+    unsigned char data = button_queue[tail];
+    
+    event->button = data & 0x07;
+    event->type = (BUTTON_Type)(data>>4);
+    
+    button_tail = (tail + 1) & (BUTTON_QUEUE_SIZE - 1);     // Release entry after it is read
+    
+    return 0x01;
+}
\ No newline at end of file
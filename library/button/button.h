@@ -0,0 +1,92 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for button library
+ *   (parallel debouncing/button events)
+ * -----------------------------------------
+ */
+
+#ifndef BUTTON_H_
+#define BUTTON_H_
+
+// Definition of BUTTON parameters
+
+#ifndef BUTTON_DDR          // Button data direction register
+    #define BUTTON_DDR DDRA
+#endif
+
+#ifndef BUTTON_PORT         // Button port (pullup resistors)
+    #define BUTTON_PORT PORTA
+#endif
+
+#ifndef BUTTON_PIN          // Button input register
+    #define BUTTON_PIN PINA
+#endif
+
+#ifndef BUTTON_MASK         // Used buttons (S0-S3 on Megacard)
+    #define BUTTON_MASK 0x0F
+#endif
+
+#ifndef BUTTON_ACTIVE_LOW   // Button pressed = LOW (pullup resistors enabled)
+    #define BUTTON_ACTIVE_LOW
+#endif
+
+#ifndef BUTTON_REPEAT_MASK  // Buttons with long press/repeat events
+    #define BUTTON_REPEAT_MASK BUTTON_MASK
+#endif
+
+#ifndef BUTTON_LONG         // Samples until long press (50 * 10 ms = 500 ms)
+    #define BUTTON_LONG 50
+#endif
+
+#ifndef BUTTON_REPEAT       // Samples between repeat events (10 * 10 ms = 100 ms)
+    #define BUTTON_REPEAT 10
+#endif
+
+#ifndef BUTTON_QUEUE_SIZE   // Event queue size (2^n)
+    #define BUTTON_QUEUE_SIZE 8
+#endif
+
+#if (BUTTON_QUEUE_SIZE & (BUTTON_QUEUE_SIZE - 1)) || (BUTTON_QUEUE_SIZE > 128)
+    #error "BUTTON_QUEUE_SIZE must be a power of 2 (max. 128)"
+#endif
+
+#if (BUTTON_LONG < 1) || (BUTTON_LONG > 255) || (BUTTON_REPEAT < 1) || (BUTTON_REPEAT > 255)
+    #error "BUTTON_LONG/BUTTON_REPEAT must be 1-255 samples"
+#endif
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+enum BUTTON_Type_t
+{
+    BUTTON_None=0,
+    BUTTON_Press,
+    BUTTON_Release,
+    BUTTON_Long,
+    BUTTON_Repeat
+};
+
+typedef enum BUTTON_Type_t BUTTON_Type;
+
+struct BUTTON_Event_t
+{
+    unsigned char button;   // Button number (0-7)
+    BUTTON_Type type;       // Event type
+};
+
+typedef struct BUTTON_Event_t BUTTON_Event;
+
+         void button_init(void);
+         void button_sample(void);
+unsigned char button_state(void);
+unsigned char button_event(BUTTON_Event *event);
+
+#endif /* BUTTON_H_ */
\ No newline at end of file
@@ -0,0 +1,70 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for debouncing buttons with
+ *   button library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+
+// User libraries
+#include "../tick/tick.h"
+#include "button.h"
+
+// Software timer callback (called from tick ISR every 10 ms)
+void sample_timer(unsigned char timer)
+{
+    button_sample();
+}
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    PORTC = 0x01;
+    
+    button_init();  // Buttons S0-S3 (PORTA(3:0)) with pullup resistors
+    tick_init();    // 1 ms system tick
+    
+    tick_timer_start(10, TICK_Periodic, sample_timer);
+    
+    BUTTON_Event event;
+    
+    while (1) 
+    {
+        if(!button_event(&event))
+            continue;   // Other work can be done here
+        
+        switch(event.button)
+        {
+            // S0: Rotate LED left (pressed or hold down)
+            case 0  :   if((event.type == BUTTON_Press) || (event.type == BUTTON_Repeat))
+                            PORTC = (PORTC<<1) | (PORTC>>7);
+                        break;
+            // S1: Rotate LED right (pressed or hold down)
+            case 1  :   if((event.type == BUTTON_Press) || (event.type == BUTTON_Repeat))
+                            PORTC = (PORTC>>1) | (PORTC<<7);
+                        break;
+            // S2: Invert PORT on release
+            case 2  :   if(event.type == BUTTON_Release)
+                            PORTC = ~PORTC;
+                        break;
+            // S3: Reset PORT on long press
+            case 3  :   if(event.type == BUTTON_Long)
+                            PORTC = 0x01;
+                        break;
+            default :   break;
+        }
+    }
+}   // End of main
\ No newline at end of file
@@ -0,0 +1,393 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for extint library
+ *   (timestamped external interrupts)
+ * -----------------------------------------
+ */
+
+#include "extint.h"
+
+#define EXTINT_CHANNELS 3
+#define EXTINT_TIMEOUT_TICKS ((EXTINT_TIMEOUT * (F_CPU / 1000UL)) / EXTINT_PRESCALER)
+
+static volatile unsigned int extint_overflow;                   // Timer1 overflows (timestamp bits 31:16)
+
+// Edge statistics (written by ISR)
+static volatile unsigned long extint_filter[EXTINT_CHANNELS];   // Minimum edge interval (ticks)
+static volatile unsigned long extint_edges[EXTINT_CHANNELS];    // Accepted edges
+static volatile unsigned long extint_last[EXTINT_CHANNELS];     // Timestamp of last edge
+static volatile unsigned long extint_delta[EXTINT_CHANNELS];    // Ticks between last two edges
+
+// Frequency measurement (reference edge of last extint_frequency() call)
+static unsigned char extint_reference[EXTINT_CHANNELS];
+static unsigned long extint_reference_edges[EXTINT_CHANNELS];
+static unsigned long extint_reference_time[EXTINT_CHANNELS];
+static unsigned long extint_hz[EXTINT_CHANNELS];
+
+// Edge buffer (written by ISRs, read by extint_read())
+static volatile EXTINT_Event extint_buffer[EXTINT_BUFFER_SIZE];
+static volatile unsigned char extint_head;
+static volatile unsigned char extint_tail;
+
+static const unsigned char extint_mask[EXTINT_CHANNELS] = { (1<<INT0), (1<<INT1), (1<<INT2) };
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT read timestamp                       |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x????????  ->  Timer ticks (EXTINT_CLOCK)      |
+//  +---------------------------------------------------------------+
+//  | Interrupts have to be disabled.                               |
+//  +---------------------------------------------------------------+
+static unsigned long extint_timestamp(void)
+{
+    unsigned int count = TCNT1;
+    unsigned int overflow = extint_overflow;
+    
+    // Overflow occurred but ISR not yet executed
+    if((TIFR & (1<<TOV1)) && !(count & 0x8000))
+        overflow++;
+    
+    return ((unsigned long)overflow<<16) | count;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT initialization                       |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  EXTINT_INT0/INT1/INT2           |
+//  |               edge        ->  EXTINT_Any/Falling/Rising       |
+//  |               filter      ->  Minimum edge interval in us     |
+//  |                               (0 = no filter)                 |
+//  |                                                               |
+//  |    Return:    0x00        ->  Interrupt enabled               |
+//  |               0xFF        ->  Invalid channel/edge or Timer1  |
+//  |                               used by another library         |
+//  +---------------------------------------------------------------+
+//  | Edges within filter time after an accepted edge are ignored   |
+//  | (e.g. contact bounce). Timer1 runs free as timestamp source   |
+//  | and global interrupts are enabled. A running Timer1 is only   |
+//  | used if it runs in normal mode with EXTINT_PRESCALER.         |
+//  +---------------------------------------------------------------+
+unsigned char extint_init(EXTINT_Channel channel, EXTINT_Edge edge, unsigned long filter)
+{
+    if((channel > EXTINT_INT2) || (edge < EXTINT_Any) || (edge > EXTINT_Rising))
+        return 0xFF;
+    
+    // INT2 only detects rising or falling edges
+    if((channel == EXTINT_INT2) && (edge == EXTINT_Any))
+        return 0xFF;
+    
+    // Timer1 running in another mode (e.g. pwm, tone) overflows at TOP
+    if((TCCR1B & 0x07) && (((TCCR1A & ((1<<WGM11) | (1<<WGM10))) || (TCCR1B & ((1<<WGM13) | (1<<WGM12)))) || ((TCCR1B & 0x07) != EXTINT_CS)))
+        return 0xFF;
+    
+    GICR &= ~extint_mask[channel];  // Disable interrupt while changing setup
+    
+    // Start timestamp timer (normal mode)
+    if(!(TCCR1B & 0x07))
+    {
+        TCCR1A = 0x00;
+        TCNT1 = 0;
+        extint_overflow = 0;
+        TIFR = (1<<TOV1);
+        TIMSK |= (1<<TOIE1);
+        TCCR1B = EXTINT_CS;
+    }
+    
+    unsigned char sreg = SREG;
+    cli();
+    
+    extint_filter[channel] = (filter * (F_CPU / 1000000UL)) / EXTINT_PRESCALER;
+    extint_edges[channel] = 0;
+    extint_delta[channel] = 0;
+    extint_reference[channel] = 0;
+    
+    SREG = sreg;
+    
+    switch(channel)
+    {
+        case EXTINT_INT0    :   DDRD &= ~(1<<PD2);
+                                #ifdef EXTINT_PULLUP
+                                    PORTD |= (1<<PD2);
+                                #endif
+                                MCUCR = (MCUCR & ~((1<<ISC01) | (1<<ISC00))) | (edge<<ISC00);
+                                break;
+        case EXTINT_INT1    :   DDRD &= ~(1<<PD3);
+                                #ifdef EXTINT_PULLUP
+                                    PORTD |= (1<<PD3);
+                                #endif
+                                MCUCR = (MCUCR & ~((1<<ISC11) | (1<<ISC10))) | (edge<<ISC10);
+                                break;
+        default             :   DDRB &= ~(1<<PB2);
+                                #ifdef EXTINT_PULLUP
+                                    PORTB |= (1<<PB2);
+                                #endif
+                                if(edge == EXTINT_Rising)
+                                    MCUCSR |= (1<<ISC2);
+                                else
+                                    MCUCSR &= ~(1<<ISC2);
+                                break;
+    }
+    
+    GIFR = extint_mask[channel];    // Clear flag set by setup change
+    GICR |= extint_mask[channel];
+    
+    sei();
+    
+    return 0x00;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT disable                              |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  EXTINT_INT0/INT1/INT2           |
+//  +---------------------------------------------------------------+
+void extint_disable(EXTINT_Channel channel)
+{
+    if(channel <= EXTINT_INT2)
+        GICR &= ~extint_mask[channel];
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT current time                         |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x????????  ->  Timer ticks (EXTINT_CLOCK)      |
+//  +---------------------------------------------------------------+
+unsigned long extint_time(void)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned long time = extint_timestamp();
+    
+    SREG = sreg;
+    
+    return time;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT ticks to microseconds                |
+//  +---------------------------------------------------------------+
+//  | Parameter:    ticks       ->  Timer ticks (EXTINT_CLOCK)      |
+//  |                                                               |
+//  |    Return:    0x????????  ->  Microseconds                    |
+//  +---------------------------------------------------------------+
+unsigned long extint_us(unsigned long ticks)
+{
+    // Split calculation to avoid overflow of ticks * prescaler
+    return ((ticks / (F_CPU / 1000000UL)) * EXTINT_PRESCALER) + (((ticks % (F_CPU / 1000000UL)) * EXTINT_PRESCALER) / (F_CPU / 1000000UL));
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT read edge                            |
+//  +---------------------------------------------------------------+
+//  | Parameter:    event       ->  Pointer to event                |
+//  |                                                               |
+//  |    Return:    0x00        ->  Buffer empty                    |
+//  |               0x01        ->  Edge read                       |
+//  +---------------------------------------------------------------+
+//  | Edges are lost if the buffer is full, the statistics are      |
+//  | updated anyway.                                               |
+//  +---------------------------------------------------------------+
+unsigned char extint_read(EXTINT_Event *event)
+{
+    unsigned char tail = extint_tail;
+    
+    if(tail == extint_head)
+        return 0x00;
+    
+    event->channel = extint_buffer[tail].channel;
+    event->time = extint_buffer[tail].time;
+    
+    extint_tail = (tail + 1) & (EXTINT_BUFFER_SIZE - 1);    // Release entry after it is read
+    
+    return 0x01;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT edge counter                         |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  EXTINT_INT0/INT1/INT2           |
+//  |                                                               |
+//  |    Return:    0x????????  ->  Accepted edges since init       |
+//  +---------------------------------------------------------------+
+unsigned long extint_count(EXTINT_Channel channel)
+{
+    if(channel > EXTINT_INT2)
+        return 0;
+    
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned long edges = extint_edges[channel];
+    
+    SREG = sreg;
+    
+    return edges;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT period                               |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  EXTINT_INT0/INT1/INT2           |
+//  |                                                               |
+//  |    Return:    0x????????  ->  Time between last two edges     |
+//  |                               in us (0 = no signal)           |
+//  +---------------------------------------------------------------+
+unsigned long extint_period(EXTINT_Channel channel)
+{
+    if(channel > EXTINT_INT2)
+        return 0;
+    
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned long delta = extint_delta[channel];
+    unsigned long idle = extint_timestamp() - extint_last[channel];
+    
+    SREG = sreg;
+    
+    if(idle > EXTINT_TIMEOUT_TICKS)
+        return 0;
+    
+    return extint_us(delta);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT edge rate                            |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  EXTINT_INT0/INT1/INT2           |
+//  |                                                               |
+//  |    Return:    0x????????  ->  Edges per second (Hz)           |
+//  |                               (0 = no signal)                 |
+//  +---------------------------------------------------------------+
+//  | Averages all edges since the previous call. The time is taken |
+//  | from the edge timestamps, so the result does not depend on    |
+//  | how regularly the function is called.                         |
+//  +---------------------------------------------------------------+
+unsigned long extint_frequency(EXTINT_Channel channel)
+{
+    if(channel > EXTINT_INT2)
+        return 0;
+    
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned long edges = extint_edges[channel];
+    unsigned long last = extint_last[channel];
+    unsigned long delta = extint_delta[channel];
+    unsigned long idle = extint_timestamp() - last;
+    
+    SREG = sreg;
+    
+    // No signal -> restart with next edges
+    if(!edges || (idle > EXTINT_TIMEOUT_TICKS))
+    {
+        extint_reference[channel] = 0;
+        extint_hz[channel] = 0;
+        
+        return 0;
+    }
+    
+    if(!extint_reference[channel])
+    {
+        // First call: Use last period
+        extint_reference[channel] = 1;
+        extint_hz[channel] = delta ? ((EXTINT_CLOCK + (delta>>1)) / delta) : 0;
+    }
+    else if(edges != extint_reference_edges[channel])
+    {
+        unsigned long count = edges - extint_reference_edges[channel];
+        unsigned long ticks = last - extint_reference_time[channel];
+        unsigned long clock = EXTINT_CLOCK;
+        
+        // Signal paused since previous call -> use last period
+        if((ticks / count) > EXTINT_TIMEOUT_TICKS)
+        {
+            ticks = delta;
+            count = 1;
+        }
+        
+        // count * clock has to fit 31 bits, scale down both times
+        while(count > (0x7FFFFFFFUL / clock))
+        {
+            clock >>= 1;
+            ticks >>= 1;
+        }
+        
+        if(ticks)
+            extint_hz[channel] = ((count * clock) + (ticks>>1)) / ticks;
+    }
+    
+    extint_reference_edges[channel] = edges;
+    extint_reference_time[channel] = last;
+    
+    return extint_hz[channel];
+}
+
+//  +---------------------------------------------------------------+
+//  |                   EXTINT capture edge                         |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  EXTINT_INT0/INT1/INT2           |
+//  +---------------------------------------------------------------+
+static void extint_capture(EXTINT_Channel channel)
+{
+    unsigned long time = extint_timestamp();
+    unsigned long delta = time - extint_last[channel];
+    
+    if(extint_edges[channel])
+    {
+        // Edge too close to last edge (e.g. bouncing) -> ignore
+        if(delta < extint_filter[channel])
+            return;
+        
+        // Signal restarted after timeout -> no valid period
+        extint_delta[channel] = (delta > EXTINT_TIMEOUT_TICKS) ? 0 : delta;
+    }
+    
+    extint_last[channel] = time;
+    extint_edges[channel]++;
+    
+    unsigned char head = extint_head;
+    unsigned char next = (head + 1) & (EXTINT_BUFFER_SIZE - 1);
+    
+    // Buffer full -> edge is lost
+    if(next == extint_tail)
+        return;
+    
+    extint_buffer[head].channel = channel;
+    extint_buffer[head].time = time;
+    extint_head = next;     // Release entry after it is written
+}
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! INT0/INT1/INT2 and TIMER1_OVF vectors are used by this      !!!
+// !!! library and cannot be defined in other files.               !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+ISR(INT0_vect)
+{
+    extint_capture(EXTINT_INT0);
+}
+
+ISR(INT1_vect)
+{
+    extint_capture(EXTINT_INT1);
+}
+
+ISR(INT2_vect)
+{
+    extint_capture(EXTINT_INT2);
+}
+
+ISR(TIMER1_OVF_vect)
+{
+    extint_overflow++;
+}
\ No newline at end of file
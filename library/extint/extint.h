@@ -0,0 +1,120 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for extint library
+ *   (timestamped external interrupts)
+ * -----------------------------------------
+ */
+
+#ifndef EXTINT_H_
+#define EXTINT_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+// Definition of EXTINT parameters
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! Timer1 and TIMER1_OVF_vect are owned by !!!
+// !!! this library (free running normal mode) !!!
+// !!! and cannot be shared with pwm (OC1A/B)  !!!
+// !!! or tone.                                !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#ifndef EXTINT_PRESCALER    // Timer1 prescaler for timestamps (1/8/64/256/1024)
+    #define EXTINT_PRESCALER 8UL
+#endif
+
+#ifndef EXTINT_BUFFER_SIZE  // Edge buffer size (2^n)
+    #define EXTINT_BUFFER_SIZE 16
+#endif
+
+#ifndef EXTINT_TIMEOUT      // No edge within timeout (ms) -> frequency = 0
+    #define EXTINT_TIMEOUT 1000UL
+#endif
+
+#ifndef EXTINT_PULLUP       // Enable pullup resistors on INTx pins
+    #define EXTINT_PULLUP
+#endif
+
+// +---------------------------------------------------------------+
+// | Timestamp resolution/range (F_CPU = 12 MHz)                   |
+// +-----------+---------------+--------------+--------------------+
+// | Prescaler | Timer clock   | Resolution   | Timestamp overflow |
+// +-----------+---------------+--------------+--------------------+
+// |         1 |   12 MHz      |   0.083 us   |     ~6 min         |
+// |         8 |  1.5 MHz      |   0.667 us   |    ~48 min         |
+// |        64 |  187.5 kHz    |   5.333 us   |    ~6.4 h          |
+// +-----------+---------------+--------------+--------------------+
+
+#if EXTINT_PRESCALER == 1UL
+    #define EXTINT_CS 0x01
+#elif EXTINT_PRESCALER == 8UL
+    #define EXTINT_CS 0x02
+#elif EXTINT_PRESCALER == 64UL
+    #define EXTINT_CS 0x03
+#elif EXTINT_PRESCALER == 256UL
+    #define EXTINT_CS 0x04
+#elif EXTINT_PRESCALER == 1024UL
+    #define EXTINT_CS 0x05
+#else
+    #error "EXTINT_PRESCALER must be 1, 8, 64, 256 or 1024"
+#endif
+
+#if (EXTINT_BUFFER_SIZE & (EXTINT_BUFFER_SIZE - 1)) || (EXTINT_BUFFER_SIZE > 128)
+    #error "EXTINT_BUFFER_SIZE must be a power of 2 (max. 128)"
+#endif
+
+#if (F_CPU % 1000000UL) != 0
+    #error "F_CPU must be a multiple of 1 MHz"
+#endif
+
+#define EXTINT_CLOCK (F_CPU / EXTINT_PRESCALER)     // Timestamp ticks per second
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+enum EXTINT_Channel_t
+{
+    EXTINT_INT0=0,      // PD2
+    EXTINT_INT1,        // PD3
+    EXTINT_INT2         // PB2
+};
+
+typedef enum EXTINT_Channel_t EXTINT_Channel;
+
+enum EXTINT_Edge_t
+{
+    EXTINT_Any=1,       // Not available on INT2
+    EXTINT_Falling,
+    EXTINT_Rising
+};
+
+typedef enum EXTINT_Edge_t EXTINT_Edge;
+
+struct EXTINT_Event_t
+{
+    EXTINT_Channel channel; // Interrupt source
+    unsigned long time;     // Timestamp (timer ticks, EXTINT_CLOCK)
+};
+
+typedef struct EXTINT_Event_t EXTINT_Event;
+
+unsigned char extint_init(EXTINT_Channel channel, EXTINT_Edge edge, unsigned long filter);
+         void extint_disable(EXTINT_Channel channel);
+unsigned long extint_time(void);
+unsigned long extint_us(unsigned long ticks);
+unsigned char extint_read(EXTINT_Event *event);
+unsigned long extint_count(EXTINT_Channel channel);
+unsigned long extint_period(EXTINT_Channel channel);
+unsigned long extint_frequency(EXTINT_Channel channel);
+
+#endif /* EXTINT_H_ */
\ No newline at end of file
@@ -0,0 +1,53 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for timestamped external
+ *   interrupts with extint library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+
+// User libraries
+#include "extint.h"
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    
+    // INT1 (PD3, connected to S0): Falling edge, ignore bouncing for 20 ms
+    extint_init(EXTINT_INT1, EXTINT_Falling, 20000UL);
+    
+    EXTINT_Event event;
+    unsigned long pressed = 0;
+    
+    while (1) 
+    {
+        // Count presses of S0 on PORTC(3:0), show time since
+        // previous press in 100 ms steps on PORTC(7:4)
+        while(extint_read(&event))
+        {
+            if(event.channel != EXTINT_INT1)
+                continue;
+            
+            unsigned long time = extint_us(event.time - pressed) / 100000UL;
+            pressed = event.time;
+            
+            if(time > 15)
+                time = 15;
+            
+            PORTC = (unsigned char)(time<<4) | ((PORTC + 1) & 0x0F);
+        }
+    }
+}   // End of main
\ No newline at end of file
@@ -0,0 +1,355 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for flash library
+ *   (25-series SPI NOR flash)
+ * -----------------------------------------
+ */
+
+#include "flash.h"
+
+#ifdef FLASH_SIMULATION
+    static unsigned char flash_memory[FLASH_SIMULATION_SIZE];   // Simulated flash array
+#else
+    static SPI_Device flash_device;                             // SPI setup of the flash
+    
+    //  +---------------------------------------------------------------+
+    //  |               FLASH instruction with address                  |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    instruction ->  Instruction code                |
+    //  |               address     ->  24 bit flash address            |
+    //  +---------------------------------------------------------------+
+    static void flash_command(unsigned char instruction, unsigned long address)
+    {
+        unsigned char data[4];
+        
+        data[0] = instruction;
+        data[1] = (unsigned char)(address>>16);
+        data[2] = (unsigned char)(address>>8);
+        data[3] = (unsigned char)(address);
+        
+        spi_write_block(data, 4);
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |               FLASH write enable                              |
+    //  +---------------------------------------------------------------+
+    static void flash_write_enable(void)
+    {
+        spi_device_select(&flash_device);
+        spi_transfer(FLASH_CMD_WRITE_ENABLE);
+        spi_device_release(&flash_device);
+    }
+#endif
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH initialization                        |
+//  +---------------------------------------------------------------+
+void flash_init(void)
+{
+    #ifdef FLASH_SIMULATION
+        memset(flash_memory, 0xFF, sizeof(flash_memory));  // Simulated flash is erased
+    #else
+        spi_device_init(&flash_device, &FLASH_CS_PORT, FLASH_CS, SPI_Mode0, spi_divider(FLASH_FREQUENCY), SPI_MSB);
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH JEDEC identification                  |
+//  +---------------------------------------------------------------+
+//  |    Return:    BIT(23:16)  ->  Manufacturer ID                 |
+//  |               BIT(15:8)   ->  Memory type                     |
+//  |               BIT(7:0)    ->  Capacity (2^n bytes)            |
+//  +---------------------------------------------------------------+
+unsigned long flash_id(void)
+{
+    #ifdef FLASH_SIMULATION
+        return FLASH_SIMULATION_ID;
+    #else
+        unsigned char data[3];
+        
+        flash_wait();
+        
+        spi_device_select(&flash_device);
+        spi_transfer(FLASH_CMD_JEDEC_ID);
+        spi_read_block(data, 3);
+        spi_device_release(&flash_device);
+        
+        return ((unsigned long)data[0]<<16) | ((unsigned long)data[1]<<8) | data[2];
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH status register                       |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x??    ->  Status register 1                   |
+//  +---------------------------------------------------------------+
+unsigned char flash_status(void)
+{
+    #ifdef FLASH_SIMULATION
+        return 0x00;
+    #else
+        spi_device_select(&flash_device);
+        spi_transfer(FLASH_CMD_READ_STATUS);
+        unsigned char status = spi_transfer(SPI_DUMMY);
+        spi_device_release(&flash_device);
+        
+        return status;
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH write/erase in progress               |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x00    ->  Flash ready                         |
+//  |               0x01    ->  Program/erase in progress           |
+//  +---------------------------------------------------------------+
+unsigned char flash_busy(void)
+{
+    return (flash_status() & FLASH_STATUS_WIP);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH wait until ready                      |
+//  +---------------------------------------------------------------+
+void flash_wait(void)
+{
+    // Poll status register until write in progress is reset
+    while(flash_busy())
+        asm volatile("NOP");
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH read data                             |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Start address                   |
+//  |               data (ptr)  ->  Receive buffer                  |
+//  |               length      ->  Number of bytes                 |
+//  +---------------------------------------------------------------+
+void flash_read(unsigned long address, unsigned char *data, unsigned int length)
+{
+    #ifdef FLASH_SIMULATION
+        for(unsigned int i=0; i < length; i++)
+            data[i] = flash_memory[(address + i) & (FLASH_SIMULATION_SIZE - 1)];
+    #else
+        flash_wait();
+        
+        spi_device_select(&flash_device);
+        flash_command(FLASH_CMD_FAST_READ, address);
+        spi_transfer(SPI_DUMMY);            // Fast read dummy byte
+        spi_read_block(data, length);
+        spi_device_release(&flash_device);
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH write data                            |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Start address                   |
+//  |               data (ptr)  ->  Transmit data                   |
+//  |               length      ->  Number of bytes                 |
+//  +---------------------------------------------------------------+
+//  | Data is split at page borders. The flash area has to be       |
+//  | erased before. The function returns while the last page is    |
+//  | programmed, the next flash access waits until it is ready.    |
+//  +---------------------------------------------------------------+
+void flash_write(unsigned long address, const unsigned char *data, unsigned int length)
+{
+    while(length)
+    {
+        // Bytes until end of page
+        unsigned int size = FLASH_PAGE_SIZE - (address % FLASH_PAGE_SIZE);
+        
+        if(size > length)
+            size = length;
+        
+        #ifdef FLASH_SIMULATION
+            // NOR flash can only clear bits
+            for(unsigned int i=0; i < size; i++)
+                flash_memory[(address + i) & (FLASH_SIMULATION_SIZE - 1)] &= data[i];
+        #else
+            flash_wait();
+            flash_write_enable();
+            
+            spi_device_select(&flash_device);
+            flash_command(FLASH_CMD_PAGE_PROGRAM, address);
+            spi_write_block(data, size);
+            spi_device_release(&flash_device);
+        #endif
+        
+        address += size;
+        data += size;
+        length -= size;
+    }
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH erase sector                          |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Address within the sector       |
+//  +---------------------------------------------------------------+
+//  | The function returns while the sector is erased, the next     |
+//  | flash access waits until it is ready.                         |
+//  +---------------------------------------------------------------+
+void flash_erase(unsigned long address)
+{
+    #ifdef FLASH_SIMULATION
+        address &= ~(FLASH_SECTOR_SIZE - 1) & (FLASH_SIMULATION_SIZE - 1);
+        memset(&flash_memory[address], 0xFF, FLASH_SECTOR_SIZE);
+    #else
+        flash_wait();
+        flash_write_enable();
+        
+        spi_device_select(&flash_device);
+        flash_command(FLASH_CMD_SECTOR_ERASE, address);
+        spi_device_release(&flash_device);
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH erase chip                            |
+//  +---------------------------------------------------------------+
+void flash_erase_chip(void)
+{
+    #ifdef FLASH_SIMULATION
+        memset(flash_memory, 0xFF, sizeof(flash_memory));
+    #else
+        flash_wait();
+        flash_write_enable();
+        
+        spi_device_select(&flash_device);
+        spi_transfer(FLASH_CMD_CHIP_ERASE);
+        spi_device_release(&flash_device);
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH log initialization                    |
+//  +---------------------------------------------------------------+
+//  | Parameter:    log (ptr)   ->  Log descriptor                  |
+//  |               start       ->  First address (sector aligned)  |
+//  |               end         ->  End address (sector aligned,    |
+//  |                               exclusive)                      |
+//  |                                                               |
+//  |    Return:    FLASH_None      ->  Log ready                   |
+//  |               FLASH_Address   ->  Area not sector aligned     |
+//  |               FLASH_Full      ->  No free page in area        |
+//  +---------------------------------------------------------------+
+//  | The log continues at the first erased page of the area. A     |
+//  | partially written page of a previous session is skipped.      |
+//  +---------------------------------------------------------------+
+FLASH_Error flash_log_init(FLASH_Log *log, unsigned long start, unsigned long end)
+{
+    if((start % FLASH_SECTOR_SIZE) || (end % FLASH_SECTOR_SIZE) || (end <= start))
+        return FLASH_Address;
+    
+    log->start = start;
+    log->end = end;
+    log->fill = 0;
+    
+    // Search first erased page
+    for(log->address = start; log->address < end; log->address += FLASH_PAGE_SIZE)
+    {
+        unsigned char data[16];
+        unsigned char used = 0;
+        
+        for(unsigned int offset=0; (offset < FLASH_PAGE_SIZE) && !used; offset += sizeof(data))
+        {
+            flash_read(log->address + offset, data, sizeof(data));
+            
+            for(unsigned char i=0; i < sizeof(data); i++)
+            {
+                if(data[i] != 0xFF)
+                {
+                    used = 1;
+                    break;
+                }
+            }
+        }
+        
+        if(!used)
+            return FLASH_None;
+    }
+    return FLASH_Full;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH log append data                       |
+//  +---------------------------------------------------------------+
+//  | Parameter:    log (ptr)   ->  Log descriptor                  |
+//  |               data (ptr)  ->  Sample data                     |
+//  |               length      ->  Number of bytes                 |
+//  |                                                               |
+//  |    Return:    FLASH_None  ->  Data appended                   |
+//  |               FLASH_Full  ->  Log area is full                |
+//  +---------------------------------------------------------------+
+//  | Data is collected in the buffer and written when the buffer   |
+//  | is full or the end of a page is reached.                      |
+//  +---------------------------------------------------------------+
+FLASH_Error flash_log_append(FLASH_Log *log, const void *data, unsigned int length)
+{
+    const unsigned char *byte = (const unsigned char *)data;
+    
+    while(length--)
+    {
+        if((log->address + log->fill) >= log->end)
+            return FLASH_Full;
+        
+        log->buffer[log->fill++] = *byte++;
+        
+        // Write buffer if full or end of page reached
+        if((log->fill >= FLASH_LOG_BUFFER) || (((log->address + log->fill) % FLASH_PAGE_SIZE) == 0))
+            flash_log_flush(log);
+    }
+    return FLASH_None;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH log write buffer                      |
+//  +---------------------------------------------------------------+
+//  | Parameter:    log (ptr)   ->  Log descriptor                  |
+//  |                                                               |
+//  |    Return:    FLASH_None  ->  Buffer written                  |
+//  |               FLASH_Full  ->  Log area is full                |
+//  +---------------------------------------------------------------+
+FLASH_Error flash_log_flush(FLASH_Log *log)
+{
+    if(log->fill == 0)
+        return FLASH_None;
+    
+    if((log->address + log->fill) > log->end)
+        return FLASH_Full;
+    
+    // Erase sector before its first page is written
+    if((log->address % FLASH_SECTOR_SIZE) == 0)
+        flash_erase(log->address);
+    
+    flash_write(log->address, log->buffer, log->fill);
+    
+    log->address += log->fill;
+    log->fill = 0;
+    
+    return FLASH_None;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   FLASH log clear                             |
+//  +---------------------------------------------------------------+
+//  | Parameter:    log (ptr)   ->  Log descriptor                  |
+//  +---------------------------------------------------------------+
+void flash_log_clear(FLASH_Log *log)
+{
+    // Erase all sectors of the log area
+    for(unsigned long address = log->start; address < log->end; address += FLASH_SECTOR_SIZE)
+        flash_erase(address);
+    
+    log->address = log->start;
+    log->fill = 0;
+}
\ No newline at end of file
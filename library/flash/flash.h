@@ -0,0 +1,138 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for flash library
+ *   (25-series SPI NOR flash)
+ * -----------------------------------------
+ */
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+// Definition of FLASH parameters
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! The SPI bus has to be initialized   !!!
+// !!! as master with spi_init() before    !!!
+// !!! flash_init() is called              !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#ifndef FLASH_CS_PORT       // Chip select port
+    #define FLASH_CS_PORT PORTB
+#endif
+
+#ifndef FLASH_CS            // Chip select pin
+    #define FLASH_CS PB4
+#endif
+
+#ifndef FLASH_FREQUENCY     // SPI clock of the flash in Hz
+    #define FLASH_FREQUENCY 6000000UL
+#endif
+
+#ifndef FLASH_PAGE_SIZE     // Page program size in bytes
+    #define FLASH_PAGE_SIZE 256UL
+#endif
+
+#ifndef FLASH_SECTOR_SIZE   // Smallest erasable sector in bytes
+    #define FLASH_SECTOR_SIZE 4096UL
+#endif
+
+#ifndef FLASH_LOG_BUFFER    // Append log buffer in bytes (FLASH_PAGE_SIZE = full page writes)
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    // !!! The buffer is located in SRAM. Use  !!!
+    // !!! a divisor of FLASH_PAGE_SIZE (e.g.  !!!
+    // !!! 64) if SRAM is short                !!!
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    #define FLASH_LOG_BUFFER 256
+#endif
+
+#if (FLASH_PAGE_SIZE % FLASH_LOG_BUFFER) != 0
+    #error "FLASH_LOG_BUFFER must be a divisor of FLASH_PAGE_SIZE"
+#endif
+
+// Definition of FLASH simulation (RAM backed flash without SPI access)
+
+//#ifndef FLASH_SIMULATION  // Simulated flash for testing on the host
+//  #define FLASH_SIMULATION
+//#endif
+
+#ifdef FLASH_SIMULATION
+    #ifndef FLASH_SIMULATION_SIZE   // Size of the simulated flash (2^n)
+        #define FLASH_SIMULATION_SIZE 8192UL
+    #endif
+    
+    #ifndef FLASH_SIMULATION_ID     // JEDEC ID of the simulated flash
+        #define FLASH_SIMULATION_ID 0xEF4014UL
+    #endif
+#endif
+
+// FLASH instruction codes (!!! Do not change !!!)
+#define FLASH_CMD_WRITE_ENABLE  0x06
+#define FLASH_CMD_READ_STATUS   0x05
+#define FLASH_CMD_PAGE_PROGRAM  0x02
+#define FLASH_CMD_FAST_READ     0x0B
+#define FLASH_CMD_SECTOR_ERASE  0x20
+#define FLASH_CMD_CHIP_ERASE    0xC7
+#define FLASH_CMD_JEDEC_ID      0x9F
+
+// FLASH status register (!!! Do not change !!!)
+#define FLASH_STATUS_WIP        0x01
+#define FLASH_STATUS_WEL        0x02
+
+#ifdef FLASH_SIMULATION
+    #include <stddef.h>
+    #include <string.h>
+#else
+    #include <avr/io.h>
+    #include "../spi/spi.h"
+    
+    #ifdef SPI_SPIE
+        #error "flash library requires SPI polling mode (SPI_SPIE not defined)"
+    #endif
+#endif
+
+enum FLASH_Error_t
+{
+    FLASH_None=0,
+    FLASH_Address,
+    FLASH_Full
+};
+typedef enum FLASH_Error_t FLASH_Error;
+
+struct FLASH_Log_t
+{
+    unsigned long start;                    // First address of the log (sector aligned)
+    unsigned long end;                      // End address of the log (sector aligned, exclusive)
+    unsigned long address;                  // Next flash address to write
+    unsigned int fill;                      // Bytes in buffer
+    unsigned char buffer[FLASH_LOG_BUFFER]; // Data not written yet
+};
+typedef struct FLASH_Log_t FLASH_Log;
+
+         void flash_init(void);
+unsigned long flash_id(void);
+unsigned char flash_status(void);
+unsigned char flash_busy(void);
+         void flash_wait(void);
+         void flash_read(unsigned long address, unsigned char *data, unsigned int length);
+         void flash_write(unsigned long address, const unsigned char *data, unsigned int length);
+         void flash_erase(unsigned long address);
+         void flash_erase_chip(void);
+
+  FLASH_Error flash_log_init(FLASH_Log *log, unsigned long start, unsigned long end);
+  FLASH_Error flash_log_append(FLASH_Log *log, const void *data, unsigned int length);
+  FLASH_Error flash_log_flush(FLASH_Log *log);
+         void flash_log_clear(FLASH_Log *log);
+
+#endif /* FLASH_H_ */
\ No newline at end of file
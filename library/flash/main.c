@@ -0,0 +1,72 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for logging data to a SPI NOR
+ *   flash with flash library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+#include <util/delay.h>
+
+// User libraries
+#include "../spi/spi.h"
+#include "flash.h"
+
+// Log area (first 64 kByte of the flash)
+#define LOG_START 0x000000UL
+#define LOG_END   0x010000UL
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    DDRA = 0x00;    // Set PORT as input
+    PORTA = 0x0F;   // Enable pullup resistor
+    
+    // SPI Initialization
+    //      Mode: SPI_Master
+    // Direction: SPI_MSB
+    //  Transfer: SPI_Mode0 (changed by device setup)
+    //     Clock: 0 (changed by device setup)
+    spi_init(SPI_Master, SPI_MSB, SPI_Mode0, 0);
+    
+    flash_init();   // Flash Initialization
+    
+    // Show manufacturer ID on LEDs (e.g. 0xEF Winbond)
+    PORTC = (unsigned char)(flash_id()>>16);
+    _delay_ms(1000);
+    
+    FLASH_Log log;
+    
+    // Continue log of last session
+    if(flash_log_init(&log, LOG_START, LOG_END) == FLASH_Full)
+        flash_log_clear(&log);
+    
+    while (1) 
+    {
+        // Erase log if S3 is pressed
+        if(!(PINA & (1<<PA3)))
+            flash_log_clear(&log);
+        
+        // Sample switches S2:0 and append to log
+        unsigned char sample = 0x07 & ~PINA;
+        
+        if(flash_log_append(&log, &sample, sizeof(sample)) == FLASH_Full)
+            PORTC = 0xFF;   // Log area full
+        else
+            PORTC = (unsigned char)(log.address>>8);    // Show progress
+        
+        _delay_ms(10);
+    }   // End of loop
+}   // End of main
\ No newline at end of file
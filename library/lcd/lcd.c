@@ -14,6 +14,70 @@
 
 #include "lcd.h"
 
+static unsigned char lcd_address;   // Tracked DDRAM address of the cursor
+static unsigned char lcd_cgram;     // CGRAM address counter active (0 = DDRAM/1 = CGRAM)
+static unsigned char lcd_column;    // Column of the cursor (may exceed LCD_COLUMNS)
+static unsigned char lcd_line;      // Row of the cursor
+
+// DDRAM start address of every display row
+static const unsigned char lcd_row[4] = { 0x00, 0x40, LCD_COLUMNS, 0x40 + LCD_COLUMNS };
+
+#if LCD_STDMODE > 0
+    // Initialize FILE stream
+    FILE lcd_stream = FDEV_SETUP_STREAM(lcd_printf, NULL, _FDEV_SETUP_WRITE);
+#endif
+
+//  +---------------------------------------------------------------+
+//  |               LCD write pattern from flash to CGRAM           |
+//  +---------------------------------------------------------------+
+//  | Parameter: address    ->  pattern ram address (0 - 7)         |
+//  |            data (ptr) ->  pattern array in PROGMEM            |
+//  +---------------------------------------------------------------+
+static void lcd_cgram_P(unsigned char address, const unsigned char *data)
+{
+    lcd_cmd(LCD_CGADDR + (address * 8));    // Setup LCD display CGADDR start address + which character
+    
+    // Write data from flash to LCD display CGRAM
+    for(unsigned char i=0; i < 8; i++)
+        lcd_char(pgm_read_byte(&data[i]));
+}
+
+static const unsigned char *lcd_glyph_table[LCD_GLYPH_SLOTS];   // PROGMEM pattern resident in slot
+static unsigned char lcd_glyph_order[LCD_GLYPH_SLOTS];          // Slots ordered from most to least recently used
+static unsigned char lcd_glyph_used;                            // Number of assigned slots
+
+// Bar graph patterns (1 - 4 columns filled, 5 columns = LCD_FULL)
+static const unsigned char lcd_bar_pattern[4][8] PROGMEM =  {
+                                                                { 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000 },
+                                                                { 0b11000, 0b11000, 0b11000, 0b11000, 0b11000, 0b11000, 0b11000, 0b11000 },
+                                                                { 0b11100, 0b11100, 0b11100, 0b11100, 0b11100, 0b11100, 0b11100, 0b11100 },
+                                                                { 0b11110, 0b11110, 0b11110, 0b11110, 0b11110, 0b11110, 0b11110, 0b11110 }
+                                                            };
+
+// Big digit segment patterns (upper bar, lower bar, upper + lower bar)
+static const unsigned char lcd_big_pattern[3][8] PROGMEM =  {
+                                                                { 0b11111, 0b11111, 0b11111, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000 },
+                                                                { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111, 0b11111, 0b11111 },
+                                                                { 0b11111, 0b11111, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111, 0b11111 }
+                                                            };
+
+// Big digit segments:  0 = space, 1 = full block,
+//                      2 = upper bar, 3 = lower bar, 4 = upper + lower bar
+//                      { upper line (3 columns), lower line (3 columns) }
+static const unsigned char lcd_big_table[11][6] PROGMEM =   {
+                                                                { 1, 2, 1, 1, 3, 1 },   // 0
+                                                                { 2, 1, 0, 3, 1, 3 },   // 1
+                                                                { 4, 4, 1, 1, 3, 3 },   // 2
+                                                                { 4, 4, 1, 3, 3, 1 },   // 3
+                                                                { 1, 3, 1, 0, 0, 1 },   // 4
+                                                                { 1, 4, 4, 3, 3, 1 },   // 5
+                                                                { 1, 4, 4, 1, 3, 1 },   // 6
+                                                                { 2, 2, 1, 0, 0, 1 },   // 7
+                                                                { 1, 4, 1, 1, 3, 1 },   // 8
+                                                                { 1, 4, 1, 3, 3, 1 },   // 9
+                                                                { 0, 0, 0, 0, 0, 0 }    // blank
+                                                            };
+
 //  +---------------------------------------------------------------+
 //  |                       LCD initialization                      |
 //  +---------------------------------------------------------------+
@@ -34,12 +98,23 @@ void lcd_init(void)
     _delay_us(LCD_FUNCTION_TIME);
     
     // Setup LCD settings
-    lcd_cmd(LCD_FUNCTION | LCD_FUNCTION_2LINE);                                 // Setup number of display lines and character font
+    #if LCD_ROWS > 1
+        lcd_cmd(LCD_FUNCTION | LCD_FUNCTION_2LINE);                             // Setup number of display lines and character font
+    #else
+        lcd_cmd(LCD_FUNCTION);                                                  // Setup number of display lines and character font
+    #endif
     lcd_cmd(LCD_DISPLAY | LCD_DISPLAY_ON);  // | LCD_CURSOR_ON | LCD_BLINK_ON); // Setup display status, display cursor, display cursor blink
     lcd_cmd(LCD_ENTRY | LCD_ENTRY_INCREMENT);                                   // Setup display cursor move direction
 
     // Clears entire display
     lcd_clear();
+    
+    // Forget glyphs from a previous initialization
+    lcd_glyph_reset();
+    
+    #if LCD_STDMODE == 1
+        stdout = &lcd_stream;
+    #endif
 }
 
 //  +---------------------------------------------------------------+
@@ -102,6 +177,30 @@ void lcd_cmd(unsigned char instruction)
     lcd_set(instruction);       // Write high nibble to databus
     lcd_set((instruction<<4));  // Write low nibble to databus
     
+    // Track the address counter of the LCD (display is write only)
+    if(instruction & LCD_DDADDR)
+    {
+        lcd_address = (0x7F & instruction);
+        lcd_cgram = 0;
+        
+        // Derive row/column from address (rows 2/3 continue rows 0/1)
+        lcd_line = ((lcd_address & 0x40) && (LCD_ROWS > 1)) ? 1 : 0;
+        
+        if(((lcd_line + 2) < LCD_ROWS) && (lcd_address >= lcd_row[lcd_line + 2]))
+            lcd_line += 2;
+        
+        lcd_column = lcd_address - lcd_row[lcd_line];
+    }
+    else if(instruction & LCD_CGADDR)
+        lcd_cgram = 1;
+    else if((instruction == LCD_CLEAR) || ((instruction & ~(0x01)) == LCD_HOME))
+    {
+        lcd_address = 0;
+        lcd_cgram = 0;
+        lcd_column = 0;
+        lcd_line = 0;
+    }
+    
     // Wait until instruction is accessed on the LCD
     _delay_us(LCD_CMD_TIME);
 }
@@ -119,6 +218,29 @@ void lcd_char(unsigned char data)
     lcd_set(data);      // Write high nibble to databus
     lcd_set((data<<4)); // Write low nibble to databus
     
+    // Increment tracked DDRAM address
+    if(!lcd_cgram)
+    {
+        #if LCD_ROWS > 1
+            // 2 line mode: 0x00-0x27/0x40-0x67
+            if(lcd_address == 0x27)
+                lcd_address = 0x40;
+            else if(lcd_address >= 0x67)
+                lcd_address = 0x00;
+            else
+                lcd_address++;
+        #else
+            // 1 line mode: 0x00-0x4F
+            if(lcd_address >= 0x4F)
+                lcd_address = 0x00;
+            else
+                lcd_address++;
+        #endif
+        
+        if(lcd_column < 0xFF)
+            lcd_column++;
+    }
+    
     // Wait until data is accessed on the LCD
     _delay_us(LCD_WRITE_TIME);
 }
@@ -138,6 +260,24 @@ void lcd_string(const char *data)
     }
 }
 
+//  +---------------------------------------------------------------+
+//  |                   LCD string transfer (flash)                 |
+//  +---------------------------------------------------------------+
+//  | Parameter:    data (ptr)  ->  ASCII/ defined character array  |
+//  |                               in PROGMEM (e.g. PSTR("..."))   |
+//  +---------------------------------------------------------------+
+void lcd_string_P(const char *data)
+{
+    char character;
+    
+    // Wait until \0 escape char is reached
+    while((character = pgm_read_byte(data)) != LCD_NULL)
+    {
+        lcd_char((unsigned char)character); // Send character
+        data++;                             // Increment data
+    }
+}
+
 //  +---------------------------------------------------------------+
 //  |                       LCD clear screen                        |
 //  +---------------------------------------------------------------+
@@ -164,15 +304,15 @@ void lcd_home(void)
 //  +---------------------------------------------------------------+
 void lcd_cursor(unsigned char x, unsigned char y)
 {
-    // Switch to LCD display line
-    switch(y)
-    {
-        case 0  :   lcd_cmd(LCD_START_ADDR + x);                    break;  // Start at display line 0 and column x
-        case 1  :   lcd_cmd(LCD_START_ADDR + 0x40 + x);             break;  // Start at display line 1 and column x
-        case 2  :   lcd_cmd(LCD_START_ADDR + LCD_COLUMNS * 2 + x);  break;  // Start at display line 2 and column x
-        case 3  :   lcd_cmd(LCD_START_ADDR + 0x50 + x);             break;  // Start at display line 3 and column x
-        default :   return; // Return if no LCD display line is set
-    }
+    // Return if no LCD display line is set
+    if(y >= LCD_ROWS)
+        return;
+    
+    // Start at display line y and column x
+    lcd_cmd(LCD_START_ADDR + lcd_row[y] + x);
+    
+    lcd_column = x;
+    lcd_line = y;
 }
 
 //  +---------------------------------------------------------------+
@@ -213,6 +353,25 @@ void lcd_pattern(LCD_Char address, const unsigned char *data)
     lcd_cmd(LCD_DDADDR);                    // Setup LCD display DDADDR (HOME position)
 }
 
+//  +---------------------------------------------------------------+
+//  |               LCD save patterns from flash to RAM             |
+//  +---------------------------------------------------------------+
+//  | Parameter: address    ->  pattern ram address                 |
+//  |                           predefined: LCD_CGADDR_CHAR0 - (n)  |
+//  |            data (ptr) ->  pattern array in PROGMEM            |
+//  |                           (5 bit x 7 rows)                    |
+//  +---------------------------------------------------------------+
+void lcd_pattern_P(LCD_Char address, const unsigned char *data)
+{
+    // Check if address is greater than max. allowed address
+    if(address > LCD_CGADDDR_MAX)
+        return;
+    
+    lcd_cgram_P(address, data);             // Write data from flash to LCD display CGRAM
+    
+    lcd_cmd(LCD_DDADDR);                    // Setup LCD display DDADDR (HOME position)
+}
+
 //  +---------------------------------------------------------------+
 //  |                   LCD unsigned long to ASCII                  |
 //  +---------------------------------------------------------------+
@@ -346,4 +505,406 @@ void lcd_d2ascii(const double data, signed char length, unsigned char precision)
     
     // Write string to LCD
     lcd_string(buffer);
+}
+
+#if LCD_STDMODE > 0
+    //  +---------------------------------------------------------------+
+    //  |                   LCD send character (stream)                 |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    data         ->  ASCII character                |
+    //  |               stream (ptr) ->  Filestream                     |
+    //  |                                                               |
+    //  |    Return:    0x00    ->  Transmission complete               |
+    //  +---------------------------------------------------------------+
+    //  | \n  ->  Cursor to start of next row (last row -> first row)   |
+    //  | \r  ->  Cursor to start of current row                        |
+    //  | \f  ->  Clear display                                         |
+    //  | Characters beyond LCD_COLUMNS wrap to the next row            |
+    //  +---------------------------------------------------------------+
+    int lcd_printf(char data, FILE *stream)
+    {
+        switch(data)
+        {
+            case '\n'   :   lcd_cursor(0, (lcd_line + 1) % LCD_ROWS);   break;
+            case '\r'   :   lcd_cursor(0, lcd_line);                    break;
+            case '\f'   :   lcd_clear();                                break;
+            default     :
+                            // Wrap to next row if end of row is reached
+                            if(lcd_column >= LCD_COLUMNS)
+                                lcd_cursor(0, (lcd_line + 1) % LCD_ROWS);
+                            
+                            lcd_char((unsigned char)data);
+                            break;
+        }
+        return 0;
+    }
+#endif
+
+//  +---------------------------------------------------------------+
+//  |                   LCD glyph manager reset                     |
+//  +---------------------------------------------------------------+
+void lcd_glyph_reset(void)
+{
+    lcd_glyph_used = 0;     // Mark all managed CGRAM slots as free
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD glyph from flash                        |
+//  +---------------------------------------------------------------+
+//  | Parameter:    pattern (ptr)   ->  pattern array in PROGMEM    |
+//  |                                   (5 bit x 8 rows)            |
+//  |                                                               |
+//  |    Return:    LCD_Char0 - 7   ->  Character code to print     |
+//  +---------------------------------------------------------------+
+//  | Patterns are identified by their flash address. If a pattern  |
+//  | is already resident in CGRAM no data is transferred, else the |
+//  | least recently used slot gets overwritten. Characters of an   |
+//  | evicted glyph that are still on screen change their shape,    |
+//  | so one screen should not use more than LCD_GLYPH_SLOTS glyphs.|
+//  +---------------------------------------------------------------+
+LCD_Char lcd_glyph(const unsigned char *pattern)
+{
+    unsigned char position;
+    unsigned char slot;
+    
+    // Search pattern in the resident slots
+    for(position=0; position < lcd_glyph_used; position++)
+    {
+        if(lcd_glyph_table[lcd_glyph_order[position]] == pattern)
+            break;
+    }
+    
+    // Pattern not resident -> take a free or the least recently used slot
+    if(position == lcd_glyph_used)
+    {
+        if(lcd_glyph_used < LCD_GLYPH_SLOTS)
+        {
+            lcd_glyph_order[position] = lcd_glyph_used;
+            lcd_glyph_used++;
+        }
+        else
+            position = LCD_GLYPH_SLOTS - 1;
+        
+        slot = lcd_glyph_order[position];
+        lcd_glyph_table[slot] = pattern;
+        
+        lcd_cgram_P(LCD_GLYPH_OFFSET + slot, pattern);  // Write data from flash to LCD display CGRAM
+        
+        lcd_cmd(LCD_DDADDR | lcd_address);              // Restore LCD display DDADDR (cursor position)
+    }
+    
+    slot = lcd_glyph_order[position];
+    
+    // Move slot to the most recently used position
+    for(; position > 0; position--)
+        lcd_glyph_order[position] = lcd_glyph_order[position - 1];
+    lcd_glyph_order[0] = slot;
+    
+    return (LCD_Char)(LCD_GLYPH_OFFSET + slot);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD bar graph initialization                |
+//  +---------------------------------------------------------------+
+//  | Parameter:    bar (ptr)   ->  bar graph widget                |
+//  |               x           ->  start column                    |
+//  |               y           ->  display line                    |
+//  |               width       ->  width in characters             |
+//  +---------------------------------------------------------------+
+void lcd_bar_init(LCD_Bar *bar, unsigned char x, unsigned char y, unsigned char width)
+{
+    bar->x = x;
+    bar->y = y;
+    bar->width = width;
+    bar->level = 0;
+    
+    // Clear the bar graph area
+    lcd_cursor(x, y);
+    
+    for(unsigned char i=0; i < width; i++)
+        lcd_char(LCD_SPACE);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD bar graph update                        |
+//  +---------------------------------------------------------------+
+//  | Parameter:    bar (ptr)   ->  bar graph widget                |
+//  |               value       ->  value to display (0 - max)      |
+//  |               max         ->  value of a full bar             |
+//  +---------------------------------------------------------------+
+//  | Every character has 5 steps. Only characters between the old  |
+//  | and the new bar end are written, so an unchanged bar costs no |
+//  | LCD transfer at all.                                          |
+//  +---------------------------------------------------------------+
+void lcd_bar(LCD_Bar *bar, unsigned int value, unsigned int max)
+{
+    if(max == 0)
+        return;
+    
+    if(value > max)
+        value = max;
+    
+    // Calculate steps of the new bar
+    unsigned int level = (unsigned int)(((unsigned long)value * bar->width * 5UL) / max);
+    
+    // Check if bar has changed
+    if(level == bar->level)
+        return;
+    
+    // Find changed characters
+    unsigned char first, last;
+    
+    if(level < bar->level)
+    {
+        first = level / 5;
+        last = bar->level / 5;
+    }
+    else
+    {
+        first = bar->level / 5;
+        last = level / 5;
+    }
+    
+    if(last >= bar->width)
+        last = bar->width - 1;
+    
+    bar->level = level;
+    
+    lcd_cursor(bar->x + first, bar->y);
+    
+    // Write changed characters
+    for(unsigned char i=first; i <= last; i++)
+    {
+        unsigned int fill = i * 5U;
+        
+        if(level >= (fill + 5))
+            lcd_char(LCD_FULL);
+        else if(level > fill)
+            lcd_char(lcd_glyph(lcd_bar_pattern[level - fill - 1]));
+        else
+            lcd_char(LCD_SPACE);
+    }
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD big number initialization               |
+//  +---------------------------------------------------------------+
+//  | Parameter:    big (ptr)   ->  big number widget               |
+//  |               x           ->  start column                    |
+//  |               y           ->  upper display line              |
+//  |               length      ->  digits (1 - LCD_BIG_LENGTH)     |
+//  +---------------------------------------------------------------+
+void lcd_big_init(LCD_Big *big, unsigned char x, unsigned char y, unsigned char length)
+{
+    if(length > LCD_BIG_LENGTH)
+        length = LCD_BIG_LENGTH;
+    
+    big->x = x;
+    big->y = y;
+    big->length = length;
+    
+    // Invalidate all digits to force a redraw on the next update
+    for(unsigned char i=0; i < LCD_BIG_LENGTH; i++)
+        big->digit[i] = 0xFF;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD big number update                       |
+//  +---------------------------------------------------------------+
+//  | Parameter:    big (ptr)   ->  big number widget               |
+//  |               value       ->  number to display (right        |
+//  |                               aligned, leading blanks)        |
+//  +---------------------------------------------------------------+
+//  | Only digits that differ from the displayed ones are written.  |
+//  +---------------------------------------------------------------+
+void lcd_big(LCD_Big *big, unsigned long value)
+{
+    // Write digits from right to left
+    for(unsigned char i=big->length; i > 0; i--)
+    {
+        unsigned char digit;
+        
+        if((value == 0) && (i < big->length))
+            digit = 10;                 // Leading blank
+        else
+        {
+            digit = value % 10;
+            value /= 10;
+        }
+        
+        // Check if digit has changed
+        if(big->digit[i - 1] == digit)
+            continue;
+        
+        big->digit[i - 1] = digit;
+        
+        // Write upper and lower line of the digit
+        for(unsigned char line=0; line < 2; line++)
+        {
+            lcd_cursor(big->x + ((i - 1) * 3), big->y + line);
+            
+            for(unsigned char column=0; column < 3; column++)
+            {
+                unsigned char segment = pgm_read_byte(&lcd_big_table[digit][(line * 3) + column]);
+                
+                switch(segment)
+                {
+                    case 0  :   lcd_char(LCD_SPACE);                                break;
+                    case 1  :   lcd_char(LCD_FULL);                                 break;
+                    default :   lcd_char(lcd_glyph(lcd_big_pattern[segment - 2]));  break;
+                }
+            }
+        }
+    }
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD marquee initialization                  |
+//  +---------------------------------------------------------------+
+//  | Parameter:    marquee (ptr)   ->  marquee widget              |
+//  |               x               ->  start column                |
+//  |               y               ->  display line                |
+//  |               width           ->  window width in characters  |
+//  |               text (ptr)      ->  text to scroll (SRAM)       |
+//  +---------------------------------------------------------------+
+void lcd_marquee_init(LCD_Marquee *marquee, unsigned char x, unsigned char y, unsigned char width, const char *text)
+{
+    marquee->x = x;
+    marquee->y = y;
+    marquee->width = width;
+    marquee->text = text;
+    marquee->flash = 0;
+    marquee->position = 0;
+    
+    // Count characters of the text
+    for(marquee->length = 0; text[marquee->length] != LCD_NULL; marquee->length++)
+        ;
+    
+    // Show first window
+    lcd_marquee(marquee);
+}
+
+//  +---------------------------------------------------------------+
+//  |               LCD marquee initialization (flash)              |
+//  +---------------------------------------------------------------+
+//  | Parameter:    marquee (ptr)   ->  marquee widget              |
+//  |               x               ->  start column                |
+//  |               y               ->  display line                |
+//  |               width           ->  window width in characters  |
+//  |               text (ptr)      ->  text to scroll (PROGMEM)    |
+//  +---------------------------------------------------------------+
+void lcd_marquee_init_P(LCD_Marquee *marquee, unsigned char x, unsigned char y, unsigned char width, const char *text)
+{
+    marquee->x = x;
+    marquee->y = y;
+    marquee->width = width;
+    marquee->text = text;
+    marquee->flash = 1;
+    marquee->position = 0;
+    
+    // Count characters of the text
+    for(marquee->length = 0; pgm_read_byte(&text[marquee->length]) != LCD_NULL; marquee->length++)
+        ;
+    
+    // Show first window
+    lcd_marquee(marquee);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD marquee step                            |
+//  +---------------------------------------------------------------+
+//  | Parameter:    marquee (ptr)   ->  marquee widget              |
+//  +---------------------------------------------------------------+
+//  | Writes the current window to the display and advances the     |
+//  | text by one character. The function never waits, so it can   |
+//  | be called every n-th timer tick from the main loop. The text  |
+//  | is windowed in software and is not limited to the 40          |
+//  | characters of a DDRAM line.                                   |
+//  +---------------------------------------------------------------+
+void lcd_marquee(LCD_Marquee *marquee)
+{
+    unsigned int cycle = marquee->length + LCD_MARQUEE_GAP;
+    unsigned int index = marquee->position;
+    
+    lcd_cursor(marquee->x, marquee->y);
+    
+    // Write visible part of the text (text + gap repeats endless)
+    for(unsigned char i=0; i < marquee->width; i++)
+    {
+        if(index >= marquee->length)
+            lcd_char(LCD_SPACE);
+        else if(marquee->flash)
+            lcd_char(pgm_read_byte(&marquee->text[index]));
+        else
+            lcd_char((unsigned char)marquee->text[index]);
+        
+        if(++index >= cycle)
+            index = 0;
+    }
+    
+    // Advance text one character
+    if(++marquee->position >= cycle)
+        marquee->position = 0;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   LCD menu from flash                         |
+//  +---------------------------------------------------------------+
+//  | Parameter:    items (ptr) ->  table of item strings, table and |
+//  |                               strings in PROGMEM              |
+//  |               count       ->  number of items                 |
+//  |               selected    ->  selected item (marked with >)   |
+//  +---------------------------------------------------------------+
+//  | Shows LCD_ROWS items, the window follows the selected item.   |
+//  |                                                               |
+//  | Example:                                                      |
+//  |   const char item0[] PROGMEM = "Voltage";                     |
+//  |   const char item1[] PROGMEM = "Current";                     |
+//  |   const char * const menu[] PROGMEM = { item0, item1 };       |
+//  |   lcd_menu_P(menu, 2, 1);                                     |
+//  +---------------------------------------------------------------+
+void lcd_menu_P(const char * const *items, unsigned char count, unsigned char selected)
+{
+    if(selected >= count)
+        return;
+    
+    // First item in window (selected item in last row if necessary)
+    unsigned char first = 0;
+    
+    if(selected >= LCD_ROWS)
+        first = selected - (LCD_ROWS - 1);
+    
+    for(unsigned char row=0; row < LCD_ROWS; row++)
+    {
+        unsigned char item = first + row;
+        unsigned char column = 1;
+        
+        lcd_cursor(0, row);
+        
+        if(item < count)
+        {
+            const char *text = (const char *)pgm_read_word(&items[item]);
+            char character;
+            
+            // Selection marker
+            if(item == selected)
+                lcd_char('>');
+            else
+                lcd_char(LCD_SPACE);
+            
+            // Item text (cut at end of row)
+            while((column < LCD_COLUMNS) && ((character = pgm_read_byte(text)) != LCD_NULL))
+            {
+                lcd_char((unsigned char)character);
+                text++;
+                column++;
+            }
+        }
+        else
+            column = 0;
+        
+        // Clear rest of row
+        for(; column < LCD_COLUMNS; column++)
+            lcd_char(LCD_SPACE);
+    }
 }
\ No newline at end of file
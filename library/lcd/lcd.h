@@ -74,6 +74,24 @@
     #define LCD_COLUMNS 8
 #endif
 
+#ifndef LCD_ROWS        // LCD display rows (1 - 4)
+    // +-------+-----------------------------+
+    // | Rows  | DDRAM start address of row  |
+    // +-------+------+------+-------+-------+
+    // |       |  0   |  1   |   2   |   3   |
+    // +-------+------+------+-------+-------+
+    // | 1x8   | 0x00 |      |       |       |
+    // | 2x16  | 0x00 | 0x40 |       |       |
+    // | 4x16  | 0x00 | 0x40 | 0x10  | 0x50  |
+    // | 4x20  | 0x00 | 0x40 | 0x14  | 0x54  |
+    // +-------+------+------+-------+-------+
+    #define LCD_ROWS 2
+#endif
+
+#if LCD_ROWS < 1 || LCD_ROWS > 4
+    #error "LCD_ROWS must be 1 - 4"
+#endif
+
 #ifndef LCD_COLUMNS_END     // LCD character memory length
     #define LCD_COLUMNS_END 80
 #endif
@@ -82,6 +100,39 @@
     #define LCD_START_ADDR 0x80
 #endif
 
+// Definition of LCD standard output mode (printf)
+#ifndef LCD_STDMODE         // Standard Mode
+    #define LCD_STDMODE 0   // 0 = None
+                            // 1 = printf (stdout)
+                            // 2 = fprintf (lcd_stream only)
+#endif
+
+// LCD glyph manager parameters
+#ifndef LCD_GLYPH_OFFSET    // First CGRAM slot used by the glyph manager (0 - 7)
+    #define LCD_GLYPH_OFFSET 0
+#endif
+
+#ifndef LCD_GLYPH_SLOTS     // Number of CGRAM slots used by the glyph manager (1 - 8)
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    // !!! Slots below LCD_GLYPH_OFFSET are left free  !!!
+    // !!! for fixed patterns written by lcd_pattern() !!!
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    #define LCD_GLYPH_SLOTS (8 - LCD_GLYPH_OFFSET)
+#endif
+
+#if (LCD_GLYPH_OFFSET + LCD_GLYPH_SLOTS) > 8 || LCD_GLYPH_SLOTS < 1
+    #error "LCD_GLYPH_OFFSET + LCD_GLYPH_SLOTS must be within 8 CGRAM slots"
+#endif
+
+// LCD widget parameters
+#ifndef LCD_BIG_LENGTH      // Max. digits of a big number widget (3 columns/digit)
+    #define LCD_BIG_LENGTH 6
+#endif
+
+#ifndef LCD_MARQUEE_GAP     // Spaces between end and restart of a scrolling text
+    #define LCD_MARQUEE_GAP 4
+#endif
+
 // LCD time/instruction codes (!!! Do not change !!!)
 
 // LCD time directives
@@ -177,8 +228,14 @@
     #define LCD_NULL 0x00
 #endif
 
+#ifndef LCD_FULL            // Full block character (character ROM A00)
+    #define LCD_FULL 0xFF
+#endif
+
+#include <stdio.h>
 #include <stdlib.h>
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 
 enum LCD_Shift_t
@@ -209,6 +266,36 @@ enum LCD_Char_t
 };
 typedef enum LCD_Char_t LCD_Char;
 
+struct LCD_Bar_t
+{
+    unsigned char x;        // Start column
+    unsigned char y;        // Display line
+    unsigned char width;    // Width in characters (5 steps/character)
+    unsigned int level;     // Displayed steps
+};
+typedef struct LCD_Bar_t LCD_Bar;
+
+struct LCD_Big_t
+{
+    unsigned char x;                        // Start column
+    unsigned char y;                        // Upper display line (uses y and y + 1)
+    unsigned char length;                   // Number of digits (1 - LCD_BIG_LENGTH)
+    unsigned char digit[LCD_BIG_LENGTH];    // Displayed digits
+};
+typedef struct LCD_Big_t LCD_Big;
+
+struct LCD_Marquee_t
+{
+    unsigned char x;        // Start column
+    unsigned char y;        // Display line
+    unsigned char width;    // Width of the window in characters
+    const char *text;       // Text to scroll (any length)
+    unsigned char flash;    // Text location (0 = SRAM/1 = PROGMEM)
+    unsigned int length;    // Length of the text
+    unsigned int position;  // Text position at the left window border
+};
+typedef struct LCD_Marquee_t LCD_Marquee;
+
 void lcd_init(void);
 void lcd_disable(void);
 void lcd_clock(void);
@@ -216,13 +303,31 @@ void lcd_set(unsigned char data);
 void lcd_cmd(unsigned char instruction);
 void lcd_char(unsigned char data);
 void lcd_string(const char *data);
+void lcd_string_P(const char *data);
 void lcd_clear(void);
 void lcd_home(void);
 void lcd_cursor(unsigned char x, unsigned char y);
 void lcd_shift(LCD_Shift shift);
 void lcd_pattern(LCD_Char address, const unsigned char *data);
+void lcd_pattern_P(LCD_Char address, const unsigned char *data);
 void lcd_ul2ascii(unsigned long data, LCD_Base base, unsigned char length);
 void lcd_sl2ascii(const signed long data, LCD_Base base, unsigned char length);
 void lcd_d2ascii(const double data, signed char length, unsigned char precision);
+void lcd_glyph_reset(void);
+LCD_Char lcd_glyph(const unsigned char *pattern);
+void lcd_bar_init(LCD_Bar *bar, unsigned char x, unsigned char y, unsigned char width);
+void lcd_bar(LCD_Bar *bar, unsigned int value, unsigned int max);
+void lcd_big_init(LCD_Big *big, unsigned char x, unsigned char y, unsigned char length);
+void lcd_big(LCD_Big *big, unsigned long value);
+void lcd_marquee_init(LCD_Marquee *marquee, unsigned char x, unsigned char y, unsigned char width, const char *text);
+void lcd_marquee_init_P(LCD_Marquee *marquee, unsigned char x, unsigned char y, unsigned char width, const char *text);
+void lcd_marquee(LCD_Marquee *marquee);
+void lcd_menu_P(const char * const *items, unsigned char count, unsigned char selected);
+
+#if LCD_STDMODE > 0
+    extern FILE lcd_stream;
+    
+    int lcd_printf(char data, FILE *stream);
+#endif
 
 #endif /* LCD_H_ */
\ No newline at end of file
@@ -18,68 +18,73 @@
 // System libraries
 #include <stdlib.h>
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 
 // User libraries
 #include "lcd.h"
 
+// Patterns and texts are stored in flash (PROGMEM) and cost no SRAM
+// Defined pattern for LCD CGRAM 64 byte / 8 = 8 Characters
+// Size of LCD display character 5 * 8 bit
+// Byte 0:  *****
+// Byte 1:  *****
+// Byte 2:  *****
+// Byte 3:  *****
+// Byte 4:  *****
+// Byte 5:  *****
+// Byte 6:  *****
+// Byte 7:  *****
+
+// Bell character
+const unsigned char pattern_bell[] PROGMEM =    {
+                                                0b00100,
+                                                0b01110,
+                                                0b01110,
+                                                0b01110,
+                                                0b11111,
+                                                0b00000,
+                                                0b00100,
+                                                0b00000
+                                                };
+
+const unsigned char pattern_G[] PROGMEM = { 0b11111, 0b11111, 0b11000, 0b11000, 0b11011, 0b11011, 0b11111, 0b11111 }; // special G character
+const unsigned char pattern_D[] PROGMEM = { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01110, 0b01110, 0b01110 }; // special . character
+const unsigned char pattern_R[] PROGMEM = { 0b11110, 0b11111, 0b11011, 0b11111, 0b11110, 0b11110, 0b11011, 0b11011 }; // special R character
+const unsigned char pattern_A[] PROGMEM = { 0b00100, 0b01110, 0b11011, 0b11011, 0b11111, 0b11111, 0b11011, 0b11011 }; // special A character
+const unsigned char pattern_F[] PROGMEM = { 0b11111, 0b11111, 0b11000, 0b11110, 0b11110, 0b11000, 0b11000, 0b11000 }; // special F character
+
+// Scrolling text
+const char text_marquee[] PROGMEM = "Megacard LCD library - text longer than one DDRAM line scrolls without blocking";
+
 int main(void)
 {
     // Port setup
     DDRA &= ~(0x0F);    // Set PORT(3:0) as input
     PORTA = 0x0F;       // Enable pullup resistor
     
-    // Defined pattern for LCD CGRAM 64 byte / 8 = 8 Characters
-    // Size of LCD display character 5 * 8 bit
-    // Byte 0:  *****
-    // Byte 1:  *****
-    // Byte 2:  *****
-    // Byte 3:  *****
-    // Byte 4:  *****
-    // Byte 5:  *****
-    // Byte 6:  *****
-    // Byte 7:  *****
-    
-    // Bell character
-    unsigned char pattern_bell[] =  {
-                                    0b00100,
-                                    0b01110,
-                                    0b01110,
-                                    0b01110,
-                                    0b11111,
-                                    0b00000,
-                                    0b00100,
-                                    0b00000
-                                    };
-
-    unsigned char pattern_G[] = { 0b11111, 0b11111, 0b11000, 0b11000, 0b11011, 0b11011, 0b11111, 0b11111 }; // special G character
-    unsigned char pattern_D[] = { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01110, 0b01110, 0b01110 }; // special . character
-    unsigned char pattern_R[] = { 0b11110, 0b11111, 0b11011, 0b11111, 0b11110, 0b11110, 0b11011, 0b11011 }; // special R character
-    unsigned char pattern_A[] = { 0b00100, 0b01110, 0b11011, 0b11011, 0b11111, 0b11111, 0b11011, 0b11011 }; // special A character
-    unsigned char pattern_F[] = { 0b11111, 0b11111, 0b11000, 0b11110, 0b11110, 0b11000, 0b11000, 0b11000 }; // special F character
-    
     // LCD display initialisation
     lcd_init();
     
     // Save self defined patterns to CGRAM
-    lcd_pattern(LCD_CGADDR_CHAR0, pattern_bell);
-    lcd_pattern(LCD_CGADDR_CHAR1, pattern_G);
-    lcd_pattern(LCD_CGADDR_CHAR2, pattern_D);
-    lcd_pattern(LCD_CGADDR_CHAR3, pattern_R);
-    lcd_pattern(LCD_CGADDR_CHAR4, pattern_A);
-    lcd_pattern(LCD_CGADDR_CHAR5, pattern_F);
+    lcd_pattern_P(LCD_CGADDR_CHAR0, pattern_bell);
+    lcd_pattern_P(LCD_CGADDR_CHAR1, pattern_G);
+    lcd_pattern_P(LCD_CGADDR_CHAR2, pattern_D);
+    lcd_pattern_P(LCD_CGADDR_CHAR3, pattern_R);
+    lcd_pattern_P(LCD_CGADDR_CHAR4, pattern_A);
+    lcd_pattern_P(LCD_CGADDR_CHAR5, pattern_F);
     // or
-    //lcd_pattern(LCD_Char0, pattern_bell);
-    //lcd_pattern(LCD_Char1, pattern_G);
-    //lcd_pattern(LCD_Char2, pattern_D);
-    //lcd_pattern(LCD_Char3, pattern_R);
-    //lcd_pattern(LCD_Char4, pattern_A);
-    //lcd_pattern(LCD_Char5, pattern_F);
+    //lcd_pattern_P(LCD_Char0, pattern_bell);
+    //lcd_pattern_P(LCD_Char1, pattern_G);
+    //lcd_pattern_P(LCD_Char2, pattern_D);
+    //lcd_pattern_P(LCD_Char3, pattern_R);
+    //lcd_pattern_P(LCD_Char4, pattern_A);
+    //lcd_pattern_P(LCD_Char5, pattern_F);
     
     // Write data to first Line
     lcd_home();                             // Set cursor to home position
     lcd_char('N');                          // Write single character to LCD display
-    lcd_string("UM");                       // Write string to LCD display
+    lcd_string_P(PSTR("UM"));               // Write string from flash to LCD display
     lcd_ul2ascii(12, LCD_Decimal, 4);           // Write unsigned long to LCD display (4 fields reserved)
     //lcd_sl2ascii(-12, LCD_Decimal, 0);        // Write signed long to LCD display (no field reserved)
     //lcd_d2ascii(2.22, 4, 2);              // Write double to LCD display in standard format
@@ -106,6 +111,18 @@ int main(void)
     //lcd_char(LCD_Char5);
     
     
+    // Timer1 CTC mode with a period of 250 ms (flag polled in loop)
+    //
+    //           F_CPU           12000000 Hz
+    // OCR1A = ---------- - 1 = ------------- - 1 = 2929
+    //          N * f_T          1024 * 4 Hz
+    OCR1A = 2929;
+    TCCR1B = (1<<WGM12) | (1<<CS12) | (1<<CS10);
+    
+    // Scrolling text (window of one display line)
+    LCD_Marquee marquee;
+    unsigned char scroll = 0;
+    
     // Endless loop
     while (1) 
     {
@@ -121,20 +138,16 @@ int main(void)
         // Check if PA1 (S1) is pressed
         if(!(PINA & (1<<PA1)))
         {
-            // Run through all columns in line
-            for (unsigned char i=0; i < LCD_COLUMNS_END; i++)
-            {
-                // Check if text appears on the screen
-                if((i < LCD_COLUMNS) || (i >= (LCD_COLUMNS_END - LCD_COLUMNS)))
-                {
-                    lcd_shift(LCD_Right);   // Shift text on lcd display right
-                    _delay_ms(500);     // Decrease speed of shifting
-                }
-                else
-                {
-                    lcd_shift(LCD_Right);   // Shift text on lcd display right
-                }
-            }
+            if(!scroll)
+                lcd_marquee_init_P(&marquee, 0, 0, LCD_COLUMNS, text_marquee);
+            scroll = 1;                 // Start scrolling text on first line
+        }
+        
+        // Scroll text one character every 250 ms (non blocking)
+        if(scroll && (TIFR & (1<<OCF1A)))
+        {
+            TIFR = (1<<OCF1A);          // Reset compare flag
+            lcd_marquee(&marquee);      // Write next text window to display
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for generating PWM signals
+ *   with pwm library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+#include <util/delay.h>
+
+// User libraries
+#include "pwm.h"
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    DDRA = 0x00;    // Set PORT as input
+    PORTA = 0x0F;   // Enable pullup resistors
+    
+    unsigned int duty = PWM_DUTY(50);
+    
+    while (1) 
+    {
+        // Select frequency with S0/S1
+        unsigned long frequency;
+        
+        switch(~PINA & 0x03)
+        {
+            case 0x01   :   frequency = 100;    break;
+            case 0x02   :   frequency = 1000;   break;
+            case 0x03   :   frequency = 10000;  break;
+            default     :   frequency = 50;     break;
+        }
+        
+        // Change duty cycle with S2/S3 (1% steps)
+        if(!(PINA & (1<<PA2)) && (duty >= PWM_DUTY(1)))
+            duty -= PWM_DUTY(1);
+        else if(!(PINA & (1<<PA3)) && (duty <= (PWM_DUTY_MAX - PWM_DUTY(1))))
+            duty += PWM_DUTY(1);
+        
+        // Timer is only set up again if the frequency changes and
+        // the compare register is only written if the duty changes
+        pwm_init(PWM_OC1A, frequency, duty);    // 16 Bit resolution
+        pwm_init(PWM_OC0, frequency, duty);     // 8 Bit, nearest frequency
+        
+        PORTC = (unsigned char)(duty>>8);       // Show duty cycle (0x80 = 100%)
+        
+        _delay_ms(20);
+    }
+}   // End of main
\ No newline at end of file
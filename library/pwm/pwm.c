@@ -0,0 +1,381 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for pwm library
+ * -----------------------------------------
+ */
+
+#include "pwm.h"
+
+#define PWM_OFF 0xFFFF      // Channel disabled (invalid duty cycle)
+
+static const unsigned char pwm_timer[4] = { 0, 1, 1, 2 };              // Timer of channel
+static const unsigned int pwm_prescaler[5] = { 1, 8, 64, 256, 1024 };  // Timer0/Timer1
+static const unsigned int pwm_prescaler2[7] = { 1, 8, 32, 64, 128, 256, 1024 };
+
+static unsigned long pwm_target[3];     // Requested frequency (0 = timer stopped)
+static unsigned long pwm_actual[3];     // Generated frequency
+static unsigned int pwm_top[3];         // Timer TOP value
+static unsigned char pwm_fast[3];       // 1 = fast PWM, 0 = phase correct PWM
+static unsigned int pwm_set[4] = { PWM_OFF, PWM_OFF, PWM_OFF, PWM_OFF };
+
+//  +---------------------------------------------------------------+
+//  |                   PWM search timer setup                      |
+//  +---------------------------------------------------------------+
+//  | Parameter:    timer       ->  Timer (0/1/2)                   |
+//  |               frequency   ->  Requested frequency (Hz)        |
+//  |               cs          ->  Clock select bits               |
+//  |               top         ->  TOP value                       |
+//  |               fast        ->  1 = fast PWM/0 = phase correct  |
+//  |                                                               |
+//  |    Return:    0x????????  ->  Generated frequency (Hz)        |
+//  |                               (0 = not possible)              |
+//  +---------------------------------------------------------------+
+//  | Tries all prescalers and both modes and takes the setup with  |
+//  | the lowest frequency error (on equal error the one with the   |
+//  | higher resolution).                                           |
+//  +---------------------------------------------------------------+
+static unsigned long pwm_search(unsigned char timer, unsigned long frequency, unsigned char *cs, unsigned int *top, unsigned char *fast)
+{
+    const unsigned int *prescaler = (timer == 2) ? pwm_prescaler2 : pwm_prescaler;
+    unsigned char prescalers = (timer == 2) ? 7 : 5;
+    
+    unsigned long best = 0xFFFFFFFFUL;
+    unsigned long actual = 0;
+    
+    if(!frequency || (frequency > F_CPU))
+        return 0;
+    
+    for(unsigned char i=0; i < prescalers; i++)
+    {
+        unsigned long n = prescaler[i];
+        
+        // Fast PWM first (higher resolution on Timer1)
+        for(unsigned char mode=0; mode < 2; mode++)
+        {
+            unsigned char pwm = !mode;
+            unsigned long counts;   // Timer clocks per PWM period
+            unsigned int value;     // TOP
+            
+            if(timer == 1)
+            {
+                if(frequency > (F_CPU / n))
+                    continue;
+                
+                // TOP = ICR1
+                //
+                // Fast PWM:            f = f_CPU / (N * (1 + TOP))
+                // Phase correct PWM:   f = f_CPU / (2 * N * TOP)
+                if(pwm)
+                {
+                    counts = (F_CPU + ((n * frequency)>>1)) / (n * frequency);
+                    
+                    if((counts < 4UL) || (counts > 65536UL))
+                        continue;
+                    
+                    value = (unsigned int)(counts - 1);
+                }
+                else
+                {
+                    counts = (F_CPU + (n * frequency)) / (2UL * n * frequency);
+                    
+                    if((counts < 3UL) || (counts > 65535UL))
+                        continue;
+                    
+                    value = (unsigned int)counts;
+                    counts <<= 1;
+                }
+            }
+            else
+            {
+                // Fixed TOP = 255
+                //
+                // Fast PWM:            f = f_CPU / (N * 256)
+                // Phase correct PWM:   f = f_CPU / (N * 510)
+                value = 255;
+                counts = pwm ? 256UL : 510UL;
+            }
+            
+            // Frequency in 1/100 Hz for comparison
+            unsigned long hz = ((F_CPU * 100UL) + ((n * counts)>>1)) / (n * counts);
+            unsigned long error = (hz > (frequency * 100UL)) ? (hz - (frequency * 100UL)) : ((frequency * 100UL) - hz);
+            
+            if(error < best)
+            {
+                best = error;
+                actual = hz;
+                
+                *cs = i + 1;
+                *top = value;
+                *fast = pwm;
+            }
+        }
+    }
+    return (actual + 50UL) / 100UL;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   PWM write duty cycle                        |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  PWM channel                     |
+//  |               duty        ->  Duty cycle (0 - PWM_DUTY_MAX)   |
+//  +---------------------------------------------------------------+
+//  | Output compare registers are double buffered in PWM mode and  |
+//  | take over the new value at TOP/BOTTOM, so no glitches occur.  |
+//  +---------------------------------------------------------------+
+static void pwm_output(PWM_Channel channel, unsigned int duty)
+{
+    unsigned char timer = pwm_timer[channel];
+    unsigned long top = pwm_top[timer];
+    unsigned int ocr;
+    unsigned char enable = 1;
+    
+    if(pwm_fast[timer])
+    {
+        // Fast PWM: duty = (OCR + 1) / (TOP + 1), OCR = 0 still
+        // generates a short pulse -> 0% disconnects the pin
+        unsigned long steps = ((duty * (top + 1)) + (PWM_DUTY_MAX>>1)) / PWM_DUTY_MAX;
+        
+        if(!steps)
+        {
+            enable = 0;
+            ocr = 0;
+        }
+        else
+            ocr = (unsigned int)(steps - 1);
+    }
+    else
+    {
+        // Phase correct PWM: duty = OCR / TOP
+        ocr = (unsigned int)(((duty * top) + (PWM_DUTY_MAX>>1)) / PWM_DUTY_MAX);
+    }
+    
+    switch(channel)
+    {
+        case PWM_OC0    :   OCR0 = (unsigned char)ocr;
+                            if(enable)
+                                TCCR0 |= (1<<COM01);
+                            else
+                            {
+                                TCCR0 &= ~(1<<COM01);
+                                PORTB &= ~(1<<PB3);
+                            }
+                            break;
+        case PWM_OC1A   :   {
+                                // 16 bit register access (TEMP register)
+                                unsigned char sreg = SREG;
+                                cli();
+                                OCR1A = ocr;
+                                SREG = sreg;
+                            }
+                            if(enable)
+                                TCCR1A |= (1<<COM1A1);
+                            else
+                            {
+                                TCCR1A &= ~(1<<COM1A1);
+                                PORTD &= ~(1<<PD5);
+                            }
+                            break;
+        case PWM_OC1B   :   {
+                                // 16 bit register access (TEMP register)
+                                unsigned char sreg = SREG;
+                                cli();
+                                OCR1B = ocr;
+                                SREG = sreg;
+                            }
+                            if(enable)
+                                TCCR1A |= (1<<COM1B1);
+                            else
+                            {
+                                TCCR1A &= ~(1<<COM1B1);
+                                PORTD &= ~(1<<PD4);
+                            }
+                            break;
+        default         :   OCR2 = (unsigned char)ocr;
+                            if(enable)
+                                TCCR2 |= (1<<COM21);
+                            else
+                            {
+                                TCCR2 &= ~(1<<COM21);
+                                PORTD &= ~(1<<PD7);
+                            }
+                            break;
+    }
+}
+
+//  +---------------------------------------------------------------+
+//  |                   PWM initialization                          |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  PWM_OC0/OC1A/OC1B/OC2           |
+//  |               frequency   ->  PWM frequency (Hz)              |
+//  |               duty        ->  Duty cycle (0 - PWM_DUTY_MAX)   |
+//  |                                                               |
+//  |    Return:    0x????????  ->  Generated frequency (Hz)        |
+//  |                               (0 = invalid parameters)        |
+//  +---------------------------------------------------------------+
+//  | The timer is only set up again if the frequency changes. On   |
+//  | Timer1 a new frequency also applies to the other channel.     |
+//  +---------------------------------------------------------------+
+unsigned long pwm_init(PWM_Channel channel, unsigned long frequency, unsigned int duty)
+{
+    if(!frequency || (channel > PWM_OC2) || (duty > PWM_DUTY_MAX))
+        return 0;
+    
+    unsigned char timer = pwm_timer[channel];
+    
+    if(frequency != pwm_target[timer])
+    {
+        unsigned char cs;
+        unsigned int top;
+        unsigned char fast;
+        
+        unsigned long actual = pwm_search(timer, frequency, &cs, &top, &fast);
+        
+        if(!actual)
+            return 0;
+        
+        pwm_target[timer] = frequency;
+        pwm_actual[timer] = actual;
+        pwm_top[timer] = top;
+        pwm_fast[timer] = fast;
+        
+        switch(timer)
+        {
+            case 0  :   TCCR0 = (TCCR0 & ((1<<COM01) | (1<<COM00))) | (1<<WGM00) | (fast ? (1<<WGM01) : 0);
+                        TCNT0 = 0;
+                        TCCR0 |= cs;
+                        break;
+            case 1  :   {
+                            TCCR1B = 0x00;  // Stop timer while TOP changes
+                            
+                            // Mode 14 (fast PWM)/Mode 10 (phase correct PWM), TOP = ICR1
+                            TCCR1A = (TCCR1A & ((1<<COM1A1) | (1<<COM1A0) | (1<<COM1B1) | (1<<COM1B0))) | (1<<WGM11);
+                            
+                            unsigned char sreg = SREG;
+                            cli();
+                            ICR1 = top;
+                            TCNT1 = 0;
+                            SREG = sreg;
+                            
+                            TCCR1B = (1<<WGM13) | (fast ? (1<<WGM12) : 0) | cs;
+                        }
+                        break;
+            default :   TCCR2 = (TCCR2 & ((1<<COM21) | (1<<COM20))) | (1<<WGM20) | (fast ? (1<<WGM21) : 0);
+                        TCNT2 = 0;
+                        TCCR2 |= cs;
+                        break;
+        }
+        
+        // Other Timer1 channel needs new compare value
+        for(unsigned char i=0; i <= PWM_OC2; i++)
+        {
+            if((i != channel) && (pwm_timer[i] == timer) && (pwm_set[i] != PWM_OFF))
+                pwm_output(i, pwm_set[i]);
+        }
+        
+        // Force update of requested channel
+        pwm_set[channel] = PWM_OFF;
+    }
+    
+    switch(channel)
+    {
+        case PWM_OC0    :   DDRB |= (1<<PB3);
+                            break;
+        case PWM_OC1A   :   DDRD |= (1<<PD5);
+                            break;
+        case PWM_OC1B   :   DDRD |= (1<<PD4);
+                            break;
+        default         :   DDRD |= (1<<PD7);
+                            break;
+    }
+    
+    pwm_duty(channel, duty);
+    
+    return pwm_actual[timer];
+}
+
+//  +---------------------------------------------------------------+
+//  |                   PWM change duty cycle                       |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  PWM_OC0/OC1A/OC1B/OC2           |
+//  |               duty        ->  Duty cycle (0 - PWM_DUTY_MAX)   |
+//  +---------------------------------------------------------------+
+//  | Registers are only written if the duty cycle changes, so the  |
+//  | function can be called in every loop.                         |
+//  +---------------------------------------------------------------+
+void pwm_duty(PWM_Channel channel, unsigned int duty)
+{
+    if((channel > PWM_OC2) || !pwm_target[pwm_timer[channel]])
+        return;
+    
+    if(duty > PWM_DUTY_MAX)
+        duty = PWM_DUTY_MAX;
+    
+    if(duty == pwm_set[channel])
+        return;
+    
+    pwm_set[channel] = duty;
+    pwm_output(channel, duty);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   PWM disable                                 |
+//  +---------------------------------------------------------------+
+//  | Parameter:    channel     ->  PWM_OC0/OC1A/OC1B/OC2           |
+//  +---------------------------------------------------------------+
+//  | Pin is switched to LOW, the timer stops if none of its        |
+//  | channels is in use.                                           |
+//  +---------------------------------------------------------------+
+void pwm_disable(PWM_Channel channel)
+{
+    if(channel > PWM_OC2)
+        return;
+    
+    unsigned char timer = pwm_timer[channel];
+    
+    // Disconnect pin from timer
+    switch(channel)
+    {
+        case PWM_OC0    :   TCCR0 &= ~(1<<COM01);
+                            PORTB &= ~(1<<PB3);
+                            break;
+        case PWM_OC1A   :   TCCR1A &= ~(1<<COM1A1);
+                            PORTD &= ~(1<<PD5);
+                            break;
+        case PWM_OC1B   :   TCCR1A &= ~(1<<COM1B1);
+                            PORTD &= ~(1<<PD4);
+                            break;
+        default         :   TCCR2 &= ~(1<<COM21);
+                            PORTD &= ~(1<<PD7);
+                            break;
+    }
+    
+    pwm_set[channel] = PWM_OFF;
+    
+    // Stop timer if unused
+    for(unsigned char i=0; i <= PWM_OC2; i++)
+    {
+        if((pwm_timer[i] == timer) && (pwm_set[i] != PWM_OFF))
+            return;
+    }
+    
+    switch(timer)
+    {
+        case 0  :   TCCR0 &= ~((1<<CS02) | (1<<CS01) | (1<<CS00));
+                    break;
+        case 1  :   TCCR1B &= ~((1<<CS12) | (1<<CS11) | (1<<CS10));
+                    break;
+        default :   TCCR2 &= ~((1<<CS22) | (1<<CS21) | (1<<CS20));
+                    break;
+    }
+    
+    pwm_target[timer] = 0;
+    pwm_actual[timer] = 0;
+}
\ No newline at end of file
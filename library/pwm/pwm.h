@@ -0,0 +1,58 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for pwm library
+ * -----------------------------------------
+ */
+
+#ifndef PWM_H_
+#define PWM_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+#if F_CPU > 42000000UL
+    #error "F_CPU too high for frequency calculation"
+#endif
+
+// Duty cycle (fixed point 1.15, 0x8000 = 100%)
+#define PWM_DUTY_MAX 0x8000U
+#define PWM_DUTY(percent) ((unsigned int)(((percent) * (unsigned long)PWM_DUTY_MAX) / 100UL))
+
+// +-----------+-------+--------+---------------------------------+
+// | Channel   | Pin   | Timer  | Resolution                      |
+// +-----------+-------+--------+---------------------------------+
+// | PWM_OC0   | PB3   | Timer0 | 8 Bit                           |
+// | PWM_OC1A  | PD5   | Timer1 | up to 16 Bit (TOP = ICR1)       |
+// | PWM_OC1B  | PD4   | Timer1 | up to 16 Bit (TOP = ICR1)       |
+// | PWM_OC2   | PD7   | Timer2 | 8 Bit                           |
+// +-----------+-------+--------+---------------------------------+
+// | OC1A and OC1B always run with the same frequency              |
+// +---------------------------------------------------------------+
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+enum PWM_Channel_t
+{
+    PWM_OC0=0,
+    PWM_OC1A,
+    PWM_OC1B,
+    PWM_OC2
+};
+
+typedef enum PWM_Channel_t PWM_Channel;
+
+unsigned long pwm_init(PWM_Channel channel, unsigned long frequency, unsigned int duty);
+         void pwm_duty(PWM_Channel channel, unsigned int duty);
+         void pwm_disable(PWM_Channel channel);
+
+#endif /* PWM_H_ */
\ No newline at end of file
@@ -0,0 +1,59 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for extending I/O lines with
+ *   74HC595/74HC165 and shift library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+#include <util/delay.h>
+
+// User libraries
+#include "../spi/spi.h"
+#include "shift.h"
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    
+    // SPI Initialization
+    //      Mode: SPI_Master
+    // Direction: SPI_MSB
+    //  Transfer: SPI_Mode0 (changed by device setup)
+    //     Clock: 0 (changed by device setup)
+    spi_init(SPI_Master, SPI_MSB, SPI_Mode0, 0);
+    
+    shift_init();   // Shift register Initialization
+    
+    unsigned char counter = 0;
+    
+    while (1) 
+    {
+        // Inputs of the 74HC165 are mirrored to the
+        // LEDs on PORTC if one of them has changed
+        if(shift_read())
+            PORTC = shift_input(0);
+        
+        // Running light on the 74HC595 outputs, input A
+        // of the 74HC165 stops it. The shift registers
+        // are only written if the outputs have changed
+        if(!shift_pin(0))
+            shift_write(0, (1<<(0x07 & counter++)));
+        
+        shift_update();
+        
+        _delay_ms(100);
+    }   // End of loop
+}   // End of main
\ No newline at end of file
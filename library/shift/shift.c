@@ -0,0 +1,218 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for shift library
+ *   (74HC595 outputs/74HC165 inputs)
+ * -----------------------------------------
+ */
+
+#include "shift.h"
+
+#if SHIFT_OUTPUTS > 0
+    static SPI_Device shift_latch;                          // 74HC595 bus setup (RCLK as chip select)
+    static unsigned char shift_shadow[SHIFT_OUTPUTS];       // Shadow copy of the outputs
+    static volatile unsigned char shift_changed;            // Shadow differs from outputs
+#endif
+
+#if SHIFT_INPUTS > 0
+    static SPI_Device shift_load;                           // 74HC165 bus setup (SH/LD as chip select)
+    static unsigned char shift_inputs[SHIFT_INPUTS];        // Last read inputs
+#endif
+
+//  +---------------------------------------------------------------+
+//  |                   SHIFT initialization                        |
+//  +---------------------------------------------------------------+
+//  | All outputs are reset to LOW and the inputs are read.         |
+//  +---------------------------------------------------------------+
+void shift_init(void)
+{
+    #if SHIFT_OUTPUTS > 0
+        // 74HC595 takes data on the rising SRCLK edge and
+        // latches it on the rising RCLK edge (chip select Off)
+        spi_device_init(&shift_latch, &SHIFT_LATCH_PORT, SHIFT_LATCH, SPI_Mode0, spi_divider(SHIFT_FREQUENCY), SPI_MSB);
+        
+        for(unsigned char i=0; i < SHIFT_OUTPUTS; i++)
+            shift_shadow[i] = 0x00;
+        
+        shift_changed = 1;
+        shift_update();
+    #endif
+    
+    #if SHIFT_INPUTS > 0
+        // 74HC165 loads the inputs while SH/LD is LOW (chip select On)
+        spi_device_init(&shift_load, &SHIFT_LOAD_PORT, SHIFT_LOAD, SPI_Mode0, spi_divider(SHIFT_FREQUENCY), SPI_MSB);
+        
+        shift_read();
+    #endif
+}
+
+#if SHIFT_OUTPUTS > 0
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT write output register                 |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    index   ->  74HC595 in chain (0 = next to MCU)  |
+    //  |               data    ->  Output data (BIT7 = QH, BIT0 = QA)  |
+    //  +---------------------------------------------------------------+
+    //  | Only the shadow copy is changed, the outputs are written      |
+    //  | with shift_update().                                          |
+    //  +---------------------------------------------------------------+
+    void shift_write(unsigned char index, unsigned char data)
+    {
+        if(index >= SHIFT_OUTPUTS)
+            return;
+        
+        if(shift_shadow[index] != data)
+        {
+            shift_shadow[index] = data;
+            shift_changed = 1;
+        }
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT read back output register             |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    index   ->  74HC595 in chain (0 = next to MCU)  |
+    //  |                                                               |
+    //  |    Return:    0x??    ->  Shadow copy of the outputs          |
+    //  +---------------------------------------------------------------+
+    unsigned char shift_output(unsigned char index)
+    {
+        if(index >= SHIFT_OUTPUTS)
+            return 0x00;
+        
+        return shift_shadow[index];
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT set output pin                        |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    pin     ->  Output (index * 8 + bit)            |
+    //  +---------------------------------------------------------------+
+    void shift_set(unsigned char pin)
+    {
+        shift_write(pin>>3, shift_output(pin>>3) | (1<<(0x07 & pin)));
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT clear output pin                      |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    pin     ->  Output (index * 8 + bit)            |
+    //  +---------------------------------------------------------------+
+    void shift_clear(unsigned char pin)
+    {
+        shift_write(pin>>3, shift_output(pin>>3) & ~(1<<(0x07 & pin)));
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT toggle output pin                     |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    pin     ->  Output (index * 8 + bit)            |
+    //  +---------------------------------------------------------------+
+    void shift_toggle(unsigned char pin)
+    {
+        shift_write(pin>>3, shift_output(pin>>3) ^ (1<<(0x07 & pin)));
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT write outputs                         |
+    //  +---------------------------------------------------------------+
+    //  |    Return:    0x00    ->  Outputs unchanged (nothing sent)    |
+    //  |               0x01    ->  Outputs written                     |
+    //  +---------------------------------------------------------------+
+    //  | The shadow copy is taken with interrupts disabled, so changes |
+    //  | from an interrupt are never written half. All outputs change  |
+    //  | together with the rising edge of RCLK.                        |
+    //  +---------------------------------------------------------------+
+    unsigned char shift_update(void)
+    {
+        unsigned char data[SHIFT_OUTPUTS];
+        
+        if(!shift_changed)
+            return 0x00;
+        
+        // Copy shadow in shift order (last 74HC595 first)
+        unsigned char sreg = SREG;
+        cli();
+        
+        for(unsigned char i=0; i < SHIFT_OUTPUTS; i++)
+            data[i] = shift_shadow[SHIFT_OUTPUTS - 1 - i];
+        
+        shift_changed = 0;
+        
+        SREG = sreg;
+        
+        spi_device_select(&shift_latch);
+        spi_write_block(data, SHIFT_OUTPUTS);
+        spi_device_release(&shift_latch);   // RCLK rising edge latches outputs
+        
+        return 0x01;
+    }
+    
+#endif
+
+#if SHIFT_INPUTS > 0
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT read inputs                           |
+    //  +---------------------------------------------------------------+
+    //  |    Return:    0x00    ->  Inputs unchanged                    |
+    //  |               0x01    ->  Inputs changed since last read      |
+    //  +---------------------------------------------------------------+
+    unsigned char shift_read(void)
+    {
+        unsigned char data[SHIFT_INPUTS];
+        unsigned char changed = 0x00;
+        
+        spi_device_select(&shift_load);     // SH/LD LOW loads all inputs
+        spi_device_release(&shift_load);    // SH/LD HIGH enables shifting
+        
+        spi_read_block(data, SHIFT_INPUTS);
+        
+        for(unsigned char i=0; i < SHIFT_INPUTS; i++)
+        {
+            if(shift_inputs[i] != data[i])
+            {
+                shift_inputs[i] = data[i];
+                changed = 0x01;
+            }
+        }
+        return changed;
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT input register                        |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    index   ->  74HC165 in chain (0 = next to MCU)  |
+    //  |                                                               |
+    //  |    Return:    0x??    ->  Input data (BIT7 = H, BIT0 = A)     |
+    //  +---------------------------------------------------------------+
+    unsigned char shift_input(unsigned char index)
+    {
+        if(index >= SHIFT_INPUTS)
+            return 0x00;
+        
+        return shift_inputs[index];
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   SHIFT input pin                             |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    pin     ->  Input (index * 8 + bit)             |
+    //  |                                                               |
+    //  |    Return:    0x00    ->  Input LOW                           |
+    //  |               0x01    ->  Input HIGH                          |
+    //  +---------------------------------------------------------------+
+    unsigned char shift_pin(unsigned char pin)
+    {
+        return (0x01 & (shift_input(pin>>3)>>(0x07 & pin)));
+    }
+    
+#endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for shift library
+ *   (74HC595 outputs/74HC165 inputs)
+ * -----------------------------------------
+ */
+
+#ifndef SHIFT_H_
+#define SHIFT_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+// Definition of SHIFT parameters
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! The SPI bus has to be initialized   !!!
+// !!! as master with spi_init() before    !!!
+// !!! shift_init() is called              !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+// Wiring:
+//
+// MOSI -> SER (74HC595 #0) QH' -> SER (74HC595 #1) ...
+// SCK  -> SRCLK (74HC595), CLK (74HC165)
+// MISO <- QH (74HC165 #0) SER <- QH (74HC165 #1) ...
+//
+// SHIFT_LATCH -> RCLK (74HC595)
+// SHIFT_LOAD  -> SH/LD (74HC165)
+//
+// 74HC595: SRCLR = HIGH, OE = LOW
+// 74HC165: CLK INH = LOW, SER of last device = LOW
+//
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! QH of the 74HC165 is always driven. !!!
+// !!! If other slaves share MISO, QH has  !!!
+// !!! to be connected over a tri-state    !!!
+// !!! buffer (e.g. 74HC125)               !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#ifndef SHIFT_OUTPUTS       // Number of chained 74HC595 (0 = none)
+    #define SHIFT_OUTPUTS 1
+#endif
+
+#ifndef SHIFT_INPUTS        // Number of chained 74HC165 (0 = none)
+    #define SHIFT_INPUTS 1
+#endif
+
+#ifndef SHIFT_LATCH_PORT    // Storage register clock port (74HC595 RCLK)
+    #define SHIFT_LATCH_PORT PORTB
+#endif
+
+#ifndef SHIFT_LATCH         // Storage register clock pin (74HC595 RCLK)
+    #define SHIFT_LATCH PB1
+#endif
+
+#ifndef SHIFT_LOAD_PORT     // Parallel load port (74HC165 SH/LD)
+    #define SHIFT_LOAD_PORT PORTB
+#endif
+
+#ifndef SHIFT_LOAD          // Parallel load pin (74HC165 SH/LD)
+    #define SHIFT_LOAD PB2
+#endif
+
+#ifndef SHIFT_FREQUENCY     // SPI clock of the shift registers in Hz
+    #define SHIFT_FREQUENCY 6000000UL
+#endif
+
+#if (SHIFT_OUTPUTS > 32) || (SHIFT_INPUTS > 32)
+    #error "Maximum of 32 chained shift registers (256 I/O lines) supported"
+#endif
+
+// Refresh time (F_CPU = 12 MHz, SHIFT_FREQUENCY = 6 MHz)
+//
+// +-------------+------------+-------------+
+// | Registers   | Bits       | Time (~us)  |
+// +-------------+------------+-------------+
+// | 1           | 8          | 2           |
+// | 2           | 16         | 4           |
+// | 4           | 32         | 8           |
+// | 8           | 64         | 15          |
+// +-------------+------------+-------------+
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "../spi/spi.h"
+
+#ifdef SPI_SPIE
+    #error "shift library requires SPI polling mode (SPI_SPIE not defined)"
+#endif
+
+         void shift_init(void);
+
+#if SHIFT_OUTPUTS > 0
+         void shift_write(unsigned char index, unsigned char data);
+unsigned char shift_output(unsigned char index);
+         void shift_set(unsigned char pin);
+         void shift_clear(unsigned char pin);
+         void shift_toggle(unsigned char pin);
+unsigned char shift_update(void);
+#endif
+
+#if SHIFT_INPUTS > 0
+unsigned char shift_read(void);
+unsigned char shift_input(unsigned char index);
+unsigned char shift_pin(unsigned char pin);
+#endif
+
+#endif /* SHIFT_H_ */
\ No newline at end of file
@@ -15,12 +15,84 @@
 
 #define F_CPU 12000000UL    // System clock (required for delay)
 
+//#define SPI_BENCHMARK     // Measure block transfer throughput (output over UART)
+
 // System libraries
 #include <avr/io.h>
 
 // User libraries
 #include "spi.h"
 
+#ifdef SPI_BENCHMARK
+    
+    #ifdef SPI_SPIE
+        #error "SPI_BENCHMARK measures the polling block transfers (SPI_SPIE disabled)"
+    #endif
+    
+    #include "../uart/uart.h"
+    
+    #define SPI_BENCHMARK_SIZE 256  // Bytes per measurement (max. 256 @ Timer1 prescaler 8)
+    
+    unsigned char buffer_tx[SPI_BENCHMARK_SIZE];
+    unsigned char buffer_rx[SPI_BENCHMARK_SIZE];
+    
+    //  +---------------------------------------------------------------+
+    //  |           Timer1 ticks to bytes/second                        |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    ticks   ->  Timer1 ticks (prescaler 8) for      |
+    //  |                           SPI_BENCHMARK_SIZE bytes            |
+    //  |                                                               |
+    //  |    Return:    Bytes/second                                    |
+    //  +---------------------------------------------------------------+
+    unsigned long throughput(unsigned int ticks)
+    {
+        return (((F_CPU / 8UL) * SPI_BENCHMARK_SIZE) + (ticks>>1)) / ticks;
+    }
+    
+    int main(void)
+    {
+        // Initialize UART(8N1) with defined parameters in uart.h
+        uart_init();
+        
+        // Timer1 free running with prescaler 8 (1 tick = 8 CPU cycles)
+        TCCR1A = 0x00;
+        TCCR1B = (1<<CS11);
+        
+        for(unsigned int i=0; i < SPI_BENCHMARK_SIZE; i++)
+            buffer_tx[i] = (unsigned char)i;
+        
+        printf("SPI block transfer, %u bytes @ %lu Hz\r\n", SPI_BENCHMARK_SIZE, F_CPU);
+        printf(" Divider SPR SPI2X |  SCK limit | spi_write_block | spi_exchange\r\n");
+        
+        // Every SPI_CLOCK/SPI2X combination (F_CPU/2 - F_CPU/128)
+        for(unsigned char i=0; i < 7; i++)
+        {
+            spi_init(SPI_Master, SPI_MSB, SPI_Mode0, F_CPU>>(i + 1));
+            
+            TCNT1 = 0;
+            spi_write_block(buffer_tx, SPI_BENCHMARK_SIZE);
+            unsigned int write = TCNT1;
+            
+            TCNT1 = 0;
+            spi_exchange(buffer_tx, buffer_rx, SPI_BENCHMARK_SIZE);
+            unsigned int exchange = TCNT1;
+            
+            // Upper bound: 8 SCK periods per byte
+            printf(" %7u %3u %5u | %6lu B/s | %11lu B/s | %8lu B/s\r\n",
+                   (2U<<i),
+                   (SPCR & ((1<<SPR1) | (1<<SPR0))),
+                   (SPSR & (1<<SPI2X)),
+                   (F_CPU / (16UL<<i)),
+                   throughput(write),
+                   throughput(exchange));
+        }
+        
+        while (1)
+            ;
+    }   // End of main
+    
+#else
+    
 int main(void)
 {   
     // Port setup
@@ -31,10 +103,11 @@ int main(void)
     // SPI Initialization
     //      Mode: SPI_Master
     // Direction: SPI_MSB
-    //  Transfer: SPI_Rising/SPI_Rising
+    //  Transfer: SPI_Mode0 (CPOL = 0, CPHA = 0)
+    //     Clock: 1 MHz (next lower setting: F_CPU / 16 = 750 kHz)
     //
     // Details can be found in spi.c
-    spi_init(SPI_Master, SPI_MSB, SPI_Rising, SPI_Rising);
+    spi_init(SPI_Master, SPI_MSB, SPI_Mode0, 1000000UL);
     
     while (1) 
     {
@@ -50,3 +123,5 @@ int main(void)
         PORTC = data;   // Write received data to output
     }   // End of loop
 }   // End of main
+
+#endif
\ No newline at end of file
@@ -14,6 +14,26 @@
 
 #include "spi.h"
 
+static SPI_Device *spi_active;  // Device the bus is configured for
+
+#ifdef SPI_SPIE
+    static SPI_Job * volatile spi_jobs[SPI_QUEUE_SIZE];   // Transaction queue
+    static volatile unsigned char spi_head;             // Next free queue entry
+    static volatile unsigned char spi_tail;             // Running transaction
+    static volatile unsigned char spi_count;            // Queued transactions
+    static volatile unsigned int spi_index;             // Byte index of running transaction
+    
+    static volatile unsigned char spi_slave_rx[SPI_SLAVE_RX_SIZE];  // Slave receive ring buffer
+    static volatile unsigned char spi_slave_rx_head;
+    static volatile unsigned char spi_slave_rx_tail;
+    static volatile unsigned char spi_slave_tx[SPI_SLAVE_TX_SIZE];  // Slave transmit ring buffer
+    static volatile unsigned char spi_slave_tx_head;
+    static volatile unsigned char spi_slave_tx_tail;
+    static volatile unsigned char spi_slave_dummy = SPI_DUMMY;      // Response if transmit buffer is empty
+    static volatile unsigned char spi_slave_count;                  // Bytes received in current frame
+    static SPI_Select spi_slave_state = SPI_Disable;                // Last polled slave select state
+#endif
+
 //  +---------------------------------------------------------------+
 //  |                   SPI initialization                          |
 //  +---------------------------------------------------------------+
@@ -24,18 +44,21 @@
 //  |                               0x00 = MSB first                |
 //  |                                                               |
 //  |                               +------+----------+---------+   |
-//  |                               |      | Polarity | Phase   |   |
+//  |                               |      | CPOL     | CPHA    |   |
 //  |                               +------+----------+---------+   |
-//  |               transfer    ->  | 0x00 | Rising   | Rising  |   |
-//  |                               | 0x01 | Rising   | Falling |   |
-//  |                               | 0x02 | Falling  | Rising  |   |
-//  |                               | 0x03 | Falling  | Falling |   |
+//  |               mode        ->  | 0x00 | 0        | 0       |   |
+//  |                               | 0x01 | 0        | 1       |   |
+//  |                               | 0x02 | 1        | 0       |   |
+//  |                               | 0x03 | 1        | 1       |   |
 //  |                               +------+----------+---------+   |
 //  |                                                               |
+//  |               frequency   ->  SCK frequency in Hz (master)    |
+//  |                               0 = SPI_CLOCK/SPI2X setup       |
+//  |                                                               |
 //  |    Return:    0x00    ->  Init complete                       |
 //  |               0xFF    ->  Master abort                        |
 //  +---------------------------------------------------------------+
-unsigned char spi_init(SPI_Mode operation, SPI_Direction direction, SPI_Polarity polarity, SPI_Phase phase)
+unsigned char spi_init(SPI_Mode operation, SPI_Direction direction, SPI_Clockmode mode, unsigned long frequency)
 {   
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
     // !!!      SPECIAL FUNCTION        !!!
@@ -46,36 +69,53 @@ unsigned char spi_init(SPI_Mode operation, SPI_Direction direction, SPI_Polarity
     SPI_DDR  &= ~((1<<SPI_MISO) | (1<<SPI_SS)); // Setup MISO and SS as input
     SPI_PORT |=   (1<<SPI_MISO) | (1<<SPI_SS);  // Activate pull up resistor at MISO and SS
     
-    // Double speed setup
-    #ifdef SPI2X
-        SPSR = (1<<SPI2X);                      // Double speed mode activated
-    #else
-        SPSR = 0x00;                            // Double speed mode deactivated
-    #endif
-    
-    #if SPI_CLOCK > 0
-        SPCR = (0x03 & SPI_CLOCK);
-    #else
-        SPCR = 0x00;
-    #endif
+    if(frequency > 0)
+    {
+        SPI_Divider divider = spi_divider(frequency);
+        
+        // Clock setup from frequency
+        SPSR = (divider & 0x04) ? (1<<SPI2X) : 0x00;
+        SPCR = (0x03 & divider);
+    }
+    else
+    {
+        // Double speed setup
+        #ifdef SPI2X
+            SPSR = (1<<SPI2X);                  // Double speed mode activated
+        #else
+            SPSR = 0x00;                        // Double speed mode deactivated
+        #endif
+        
+        #if SPI_CLOCK > 0
+            SPCR = (0x03 & SPI_CLOCK);
+        #else
+            SPCR = 0x00;
+        #endif
+    }
     
     // Master/Slave setup (direction setup)
-    SPCR |= ((0x01 & operation)<<4);
+    SPCR |= ((0x01 & operation)<<MSTR);
     
     // MSB/LSB first
-    SPCR |= ((0x01 & direction)<<5);
+    SPCR |= ((0x01 & direction)<<DORD);
     
-    // Polarity and Phase of SCK and DATA
-    SPCR |= ((0x04 & polarity)<<3) | ((0x02 & phase)<<2);
+    // Polarity (CPOL = mode bit 1) and Phase (CPHA = mode bit 0) of SCK and DATA
+    SPCR |= ((0x03 & mode)<<CPHA);
     
     // SPI interrupt setup
     #ifdef SPI_SPIE
         SPCR  |= (1<<SPIE);
         sei();
+        
+        // Preload slave response for the first transfer
+        if(operation == SPI_Slave)
+            SPDR = spi_slave_dummy;
     #endif
     
     SPCR |= (1<<SPE);   // Activate the SPI Controller
     
+    spi_active = NULL;  // Bus setup does not belong to a device
+    
     // Setup SCK, MOSI and SS as output
     // PORT configuration gets overwritten from SPI controller
     SPI_DDR  |= (1<<SPI_SCK) | (1<<SPI_MISO) | (1<<SPI_MOSI) | (1<<SPI_SS);
@@ -86,6 +126,34 @@ unsigned char spi_init(SPI_Mode operation, SPI_Direction direction, SPI_Polarity
     return 0x00;        // Return no fault
 }
 
+//  +---------------------------------------------------------------+
+//  |                   SPI clock divider                           |
+//  +---------------------------------------------------------------+
+//  | Parameter:    frequency   ->  SCK frequency in Hz             |
+//  |                                                               |
+//  |    Return:    SPI_Div2 - SPI_Div128                           |
+//  +---------------------------------------------------------------+
+//  | Selects the fastest divider that does not exceed the given    |
+//  | frequency (slowest divider if frequency < F_CPU / 128)        |
+//  +---------------------------------------------------------------+
+SPI_Divider spi_divider(unsigned long frequency)
+{
+    unsigned char i;
+    
+    // Divider = 2^(i + 1)
+    for(i=0; i < 6; i++)
+    {
+        if((F_CPU>>(i + 1)) <= frequency)
+            break;
+    }
+    
+    if(i == 6)
+        return SPI_Div128;
+    
+    // Odd powers of two are set up with SPI2X
+    return (SPI_Divider)((i>>1) | ((i & 0x01) ? 0x00 : 0x04));
+}
+
 //  +---------------------------------------------------------------+
 //  |                   SPI disable function                        |
 //  +---------------------------------------------------------------+
@@ -131,6 +199,62 @@ SPI_Select spi_slave_select(void)
         return SPI_Disable;
 }
 
+//  +---------------------------------------------------------------+
+//  |               SPI device initialization                       |
+//  +---------------------------------------------------------------+
+//  | Parameter:    device (ptr)    ->  Device descriptor           |
+//  |               port (ptr)      ->  Chip select port            |
+//  |               pin             ->  Chip select pin             |
+//  |               mode            ->  SPI_Mode0 - SPI_Mode3       |
+//  |               divider         ->  SPI_Div2 - SPI_Div128       |
+//  |               direction       ->  SPI_MSB/SPI_LSB             |
+//  +---------------------------------------------------------------+
+//  | The bus has to be initialized as master with spi_init()       |
+//  +---------------------------------------------------------------+
+void spi_device_init(SPI_Device *device, volatile unsigned char *port, unsigned char pin, SPI_Clockmode mode, SPI_Divider divider, SPI_Direction direction)
+{
+    device->port = port;
+    device->pin = pin;
+    
+    // Calculate register setup of the device
+    device->spcr = (1<<SPE) | (1<<MSTR) | ((0x01 & direction)<<DORD) | ((0x03 & mode)<<CPHA) | (0x03 & divider);
+    device->spsr = (divider & 0x04) ? (1<<SPI2X) : 0x00;
+    
+    // Setup chip select as output (HIGH = inactive)
+    // DDRx is located one address below PORTx
+    *port |= (1<<pin);
+    *(port - 1) |= (1<<pin);
+}
+
+//  +---------------------------------------------------------------+
+//  |               SPI device select                               |
+//  +---------------------------------------------------------------+
+//  | Parameter:    device (ptr)    ->  Device descriptor           |
+//  +---------------------------------------------------------------+
+//  | SPCR/SPSR are only written if another device was active       |
+//  +---------------------------------------------------------------+
+void spi_device_select(SPI_Device *device)
+{
+    if(spi_active != device)
+    {
+        SPCR = device->spcr | (SPCR & (1<<SPIE));   // Keep interrupt setup
+        SPSR = device->spsr;
+        spi_active = device;
+    }
+    
+    *device->port &= ~(1<<device->pin);             // Chip select On
+}
+
+//  +---------------------------------------------------------------+
+//  |               SPI device release                              |
+//  +---------------------------------------------------------------+
+//  | Parameter:    device (ptr)    ->  Device descriptor           |
+//  +---------------------------------------------------------------+
+void spi_device_release(SPI_Device *device)
+{
+    *device->port |= (1<<device->pin);              // Chip select Off
+}
+
 #ifndef SPI_SPIE
 
     //  +---------------------------------------------------------------+
@@ -194,4 +318,405 @@ SPI_Select spi_slave_select(void)
         }
         return SPI_None;                // Return that no new data received
     }
+    
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    // !!! Block transfers (master)                       !!!
+    // !!! The SPI receiver is double buffered, so the    !!!
+    // !!! next byte is written right after SPIF is set   !!!
+    // !!! and the previous byte is read afterwards. The  !!!
+    // !!! next byte is loaded into a register while the  !!!
+    // !!! current byte is shifted out. With SPI2X and    !!!
+    // !!! SPI_CLOCK 0x00 a byte takes 16 CPU cycles on   !!!
+    // !!! the bus, polling SPIF and storing the data     !!!
+    // !!! add cycles on top of that. The table shows the !!!
+    // !!! upper bound given by SCK (8 SCK per byte):     !!!
+    // !!!                                                !!!
+    // !!! +------------+--------------+--------------+   !!!
+    // !!! | SPI_CLOCK  | SPI2X = 0    | SPI2X = 1    |   !!!
+    // !!! +------------+--------------+--------------+   !!!
+    // !!! | 0x00       | 375 kByte/s  | 750 kByte/s  |   !!!
+    // !!! | 0x01       |  94 kByte/s  | 188 kByte/s  |   !!!
+    // !!! | 0x02       |  23 kByte/s  |  47 kByte/s  |   !!!
+    // !!! | 0x03       |  12 kByte/s  |  23 kByte/s  |   !!!
+    // !!! +------------+--------------+--------------+   !!!
+    // !!! (upper bound @ F_CPU = 12 MHz, the real values !!!
+    // !!! are measured with SPI_BENCHMARK in main.c)     !!!
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    
+    //  +---------------------------------------------------------------+
+    //  |           SPI master transmit block                           |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    data (ptr)  ->  Transmit data                   |
+    //  |               length      ->  Number of bytes                 |
+    //  +---------------------------------------------------------------+
+    void spi_write_block(const unsigned char *data, unsigned int length)
+    {
+        if(length == 0)
+            return;
+        
+        SPDR = *data++;     // Initiate first transmission
+        
+        while(--length)
+        {
+            unsigned char next = *data++;   // Load next byte while shifting
+            
+            // Wait until transmission is complete
+            while(!(SPSR & (1<<SPIF)))
+                ;
+            
+            SPDR = next;    // Initiate next transmission and reset SPIF
+        }
+        
+        // Wait until last transmission is complete
+        while(!(SPSR & (1<<SPIF)))
+            ;
+        
+        SPDR;               // Discard received data and reset SPIF
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |           SPI master receive block                            |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    data (ptr)  ->  Receive buffer                  |
+    //  |               length      ->  Number of bytes                 |
+    //  |                                                               |
+    //  | Transmits SPI_DUMMY for every received byte                   |
+    //  +---------------------------------------------------------------+
+    void spi_read_block(unsigned char *data, unsigned int length)
+    {
+        if(length == 0)
+            return;
+        
+        SPDR = SPI_DUMMY;   // Initiate first transmission
+        
+        while(--length)
+        {
+            // Wait until transmission is complete
+            while(!(SPSR & (1<<SPIF)))
+                ;
+            
+            // The previous byte has to be read before the next one is
+            // shifted in, an interrupt must not delay it
+            unsigned char sreg = SREG;
+            cli();
+            
+            SPDR = SPI_DUMMY;   // Initiate next transmission and reset SPIF
+            unsigned char received = SPDR;  // Read previous byte from receive buffer
+            
+            SREG = sreg;
+            
+            *data++ = received;
+        }
+        
+        // Wait until last transmission is complete
+        while(!(SPSR & (1<<SPIF)))
+            ;
+        
+        *data = SPDR;       // Read last byte and reset SPIF
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |           SPI master transmit/receive block                   |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    tx (ptr)    ->  Transmit data                   |
+    //  |               rx (ptr)    ->  Receive buffer (may be equal    |
+    //  |                               to tx)                          |
+    //  |               length      ->  Number of bytes                 |
+    //  +---------------------------------------------------------------+
+    void spi_exchange(const unsigned char *tx, unsigned char *rx, unsigned int length)
+    {
+        if(length == 0)
+            return;
+        
+        SPDR = *tx++;       // Initiate first transmission
+        
+        while(--length)
+        {
+            unsigned char next = *tx++;     // Load next byte while shifting
+            
+            // Wait until transmission is complete
+            while(!(SPSR & (1<<SPIF)))
+                ;
+            
+            // The previous byte has to be read before the next one is
+            // shifted in, an interrupt must not delay it
+            unsigned char sreg = SREG;
+            cli();
+            
+            SPDR = next;    // Initiate next transmission and reset SPIF
+            unsigned char received = SPDR;  // Read previous byte from receive buffer
+            
+            SREG = sreg;
+            
+            *rx++ = received;
+        }
+        
+        // Wait until last transmission is complete
+        while(!(SPSR & (1<<SPIF)))
+            ;
+        
+        *rx = SPDR;         // Read last byte and reset SPIF
+    }
 #endif
+
+#ifdef SPI_SPIE
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI chip select of a transaction                |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    job (ptr)   ->  Transaction                     |
+    //  |               mode        ->  SPI_Enable/SPI_Disable          |
+    //  +---------------------------------------------------------------+
+    static void spi_job_select(SPI_Job *job, SPI_Select mode)
+    {
+        if(job->device != NULL)
+        {
+            if(mode == SPI_Enable)
+                spi_device_select(job->device);
+            else
+                spi_device_release(job->device);
+        }
+        else if(job->port == NULL)
+            spi_select(mode);
+        else if(mode == SPI_Enable)
+            *job->port &= ~(1<<job->pin);
+        else
+            *job->port |= (1<<job->pin);
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI start next transaction                      |
+    //  +---------------------------------------------------------------+
+    //  | Called with SPI interrupt disabled or from ISR                |
+    //  +---------------------------------------------------------------+
+    static void spi_job_start(void)
+    {
+        if(spi_count)
+        {
+            SPI_Job *job = spi_jobs[spi_tail];
+            
+            job->status = SPI_Running;
+            spi_index = 0;
+            
+            spi_job_select(job, SPI_Enable);
+            SPDR = (job->tx != NULL) ? job->tx[0] : SPI_DUMMY;  // Initiate first byte
+        }
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI queue transaction                           |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    job (ptr)   ->  Transaction (has to be valid    |
+    //  |                               until it is complete)           |
+    //  |                                                               |
+    //  |    Return:    0x00    ->  Transaction queued                  |
+    //  |               0xFF    ->  Queue full                          |
+    //  +---------------------------------------------------------------+
+    unsigned char spi_queue(SPI_Job *job)
+    {
+        unsigned char status = 0xFF;
+        
+        // Empty transaction is complete immediately
+        if(job->length == 0)
+        {
+            job->status = SPI_Complete;
+            
+            if(job->callback != NULL)
+                job->callback(job);
+            
+            return 0x00;
+        }
+        
+        SPCR &= ~(1<<SPIE);     // Lock SPI interrupt
+        
+        if(spi_count < SPI_QUEUE_SIZE)
+        {
+            job->status = SPI_Queued;
+            
+            spi_jobs[spi_head] = job;
+            
+            if(++spi_head >= SPI_QUEUE_SIZE)
+                spi_head = 0;
+            
+            // Start transaction if bus is idle
+            if(spi_count++ == 0)
+                spi_job_start();
+            
+            status = 0x00;
+        }
+        
+        SPCR |= (1<<SPIE);      // Unlock SPI interrupt
+        
+        return status;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI transactions pending                        |
+    //  +---------------------------------------------------------------+
+    //  |    Return:    0x00    ->  Queue empty                         |
+    //  |               0x??    ->  Number of pending transactions      |
+    //  +---------------------------------------------------------------+
+    unsigned char spi_busy(void)
+    {
+        return spi_count;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI transfer complete interrupt                 |
+    //  +---------------------------------------------------------------+
+    ISR(SPI_STC_vect)
+    {
+        // Slave mode
+        if(!(SPCR & (1<<MSTR)))
+        {
+            unsigned char data = SPDR;
+            unsigned char tail = spi_slave_tx_tail;
+            
+            // Preload response for the next transfer
+            if(tail != spi_slave_tx_head)
+            {
+                SPDR = spi_slave_tx[tail];
+                spi_slave_tx_tail = (tail + 1) & (SPI_SLAVE_TX_SIZE - 1);
+            }
+            else
+                SPDR = spi_slave_dummy;
+            
+            // Save received data (discarded if buffer is full)
+            unsigned char head = (spi_slave_rx_head + 1) & (SPI_SLAVE_RX_SIZE - 1);
+            
+            if(head != spi_slave_rx_tail)
+            {
+                spi_slave_rx[spi_slave_rx_head] = data;
+                spi_slave_rx_head = head;
+            }
+            
+            spi_slave_count++;
+            return;
+        }
+        
+        SPI_Job *job = spi_jobs[spi_tail];
+        unsigned int index = spi_index;
+        unsigned char data = SPDR;
+        
+        // Preload next byte first to keep the bus busy
+        if(++index < job->length)
+            SPDR = (job->tx != NULL) ? job->tx[index] : SPI_DUMMY;
+        
+        if(job->rx != NULL)
+            job->rx[index - 1] = data;
+        
+        spi_index = index;
+        
+        // Check if transaction is complete
+        if(index >= job->length)
+        {
+            spi_job_select(job, SPI_Disable);
+            job->status = SPI_Complete;
+            
+            if(++spi_tail >= SPI_QUEUE_SIZE)
+                spi_tail = 0;
+            spi_count--;
+            
+            spi_job_start();    // Start next queued transaction
+            
+            // Callback may queue a new transaction
+            if(job->callback != NULL)
+                job->callback(job);
+        }
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI slave write to transmit buffer              |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    data (ptr)  ->  Data to transmit                |
+    //  |               length      ->  Number of bytes                 |
+    //  |                                                               |
+    //  |    Return:    0x??    ->  Bytes written to buffer             |
+    //  +---------------------------------------------------------------+
+    unsigned char spi_slave_write(const unsigned char *data, unsigned char length)
+    {
+        unsigned char count;
+        
+        for(count=0; count < length; count++)
+        {
+            unsigned char head = (spi_slave_tx_head + 1) & (SPI_SLAVE_TX_SIZE - 1);
+            
+            // Check if buffer is full
+            if(head == spi_slave_tx_tail)
+                break;
+            
+            spi_slave_tx[spi_slave_tx_head] = data[count];
+            spi_slave_tx_head = head;
+        }
+        return count;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI slave read from receive buffer              |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    data (ptr)  ->  Receive buffer                  |
+    //  |               length      ->  Size of receive buffer          |
+    //  |                                                               |
+    //  |    Return:    0x??    ->  Bytes read from buffer              |
+    //  +---------------------------------------------------------------+
+    unsigned char spi_slave_read(unsigned char *data, unsigned char length)
+    {
+        unsigned char count;
+        
+        for(count=0; (count < length) && (spi_slave_rx_tail != spi_slave_rx_head); count++)
+        {
+            data[count] = spi_slave_rx[spi_slave_rx_tail];
+            spi_slave_rx_tail = (spi_slave_rx_tail + 1) & (SPI_SLAVE_RX_SIZE - 1);
+        }
+        return count;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI slave default response                      |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    data    ->  Byte transmitted if the transmit    |
+    //  |                           buffer is empty                     |
+    //  +---------------------------------------------------------------+
+    void spi_slave_response(unsigned char data)
+    {
+        spi_slave_dummy = data;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               SPI slave frame detection                       |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    length (ptr)    ->  Bytes of the finished frame |
+    //  |                                   (SPI_Frame_End only)        |
+    //  |                                                               |
+    //  |    Return:    SPI_Frame_None  ->  No edge on slave select     |
+    //  |               SPI_Frame_Start ->  Falling edge (frame starts) |
+    //  |               SPI_Frame_End   ->  Rising edge (frame ends)    |
+    //  +---------------------------------------------------------------+
+    //  | Has to be polled faster than the gap between two frames or    |
+    //  | called from an external interrupt wired to the SS line.       |
+    //  +---------------------------------------------------------------+
+    SPI_Frame spi_slave_frame(unsigned char *length)
+    {
+        SPI_Select state = spi_slave_select();
+        
+        if(state == spi_slave_state)
+            return SPI_Frame_None;
+        
+        spi_slave_state = state;
+        
+        if(state == SPI_Enable)
+            return SPI_Frame_Start;
+        
+        // Frame finished -> return and reset byte counter
+        SPCR &= ~(1<<SPIE);
+        
+        if(length != NULL)
+            *length = spi_slave_count;
+        spi_slave_count = 0;
+        
+        SPCR |= (1<<SPIE);
+        
+        return SPI_Frame_End;
+    }
+
+#endif
\ No newline at end of file
@@ -24,6 +24,10 @@
 // !!! SPI clock f_CPU > 4 * f_SPI   !!! 
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! 
 
+#ifndef F_CPU       // System clock
+    #define F_CPU 12000000UL
+#endif
+
 #ifndef SPI2X       // Double speed mode
     #define SPI2X
 #endif
@@ -82,22 +86,41 @@
 
 // Definition of SPI processing (Enabled = Interrupt/Disabled = Polling)
 
-// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-// !!! Interrupts are not included in this library !!!
-// !!! If interrupts are used, disable the polling !!!
-// !!! by uncommenting the next lines              !!!
-// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!! If interrupts are used, the polling will be  !!!
+// !!! disabled and master transfers are processed  !!!
+// !!! from a transaction queue (spi_queue) by the  !!!
+// !!! SPI interrupt of the library                 !!!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 //#ifndef SPI_SPIE  // SPI Interrupt based processing
 //  #define SPI_SPIE
 //#endif
 
-#include <avr/io.h>
+#ifndef SPI_QUEUE_SIZE  // Max. queued transactions (interrupt based processing)
+    #define SPI_QUEUE_SIZE 4
+#endif
+
+#ifndef SPI_DUMMY       // Byte transmitted if a transaction has no tx buffer
+    #define SPI_DUMMY 0xFF
+#endif
+
+#ifndef SPI_SLAVE_RX_SIZE   // Slave receive ring buffer (interrupt based processing, 2^n)
+    #define SPI_SLAVE_RX_SIZE 16
+#endif
 
-#ifdef SPI_SPIE
-    #include <avr/interrupt.h>
+#ifndef SPI_SLAVE_TX_SIZE   // Slave transmit ring buffer (interrupt based processing, 2^n)
+    #define SPI_SLAVE_TX_SIZE 16
 #endif
 
+#if (SPI_SLAVE_RX_SIZE & (SPI_SLAVE_RX_SIZE - 1)) || (SPI_SLAVE_TX_SIZE & (SPI_SLAVE_TX_SIZE - 1))
+    #error "SPI_SLAVE_RX_SIZE and SPI_SLAVE_TX_SIZE must be a power of 2"
+#endif
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
 enum SPI_Mode_t
 {
     SPI_Slave=0,
@@ -135,14 +158,87 @@ enum SPI_Status_t
 };
 typedef enum SPI_Status_t SPI_Status;
 
-unsigned char spi_init(SPI_Mode operation, SPI_Direction direction, SPI_Polarity polarity, SPI_Phase phase);
+enum SPI_Frame_t
+{
+    SPI_Frame_None=0,
+    SPI_Frame_Start,
+    SPI_Frame_End
+};
+typedef enum SPI_Frame_t SPI_Frame;
+
+enum SPI_Clockmode_t
+{
+    SPI_Mode0=0,    // CPOL = 0, CPHA = 0
+    SPI_Mode1,      // CPOL = 0, CPHA = 1
+    SPI_Mode2,      // CPOL = 1, CPHA = 0
+    SPI_Mode3       // CPOL = 1, CPHA = 1
+};
+typedef enum SPI_Clockmode_t SPI_Clockmode;
+
+enum SPI_Divider_t  // Bit(1:0) = SPR1:0, Bit(2) = SPI2X
+{
+    SPI_Div2=0x04,
+    SPI_Div4=0x00,
+    SPI_Div8=0x05,
+    SPI_Div16=0x01,
+    SPI_Div32=0x06,
+    SPI_Div64=0x02,
+    SPI_Div128=0x03
+};
+typedef enum SPI_Divider_t SPI_Divider;
+
+struct SPI_Device_t
+{
+    volatile unsigned char *port;   // Chip select port (e.g. &PORTB)
+    unsigned char pin;              // Chip select pin (active LOW)
+    unsigned char spcr;             // SPCR setup of the device
+    unsigned char spsr;             // SPSR setup of the device
+};
+typedef struct SPI_Device_t SPI_Device;
+
+enum SPI_Job_Status_t
+{
+    SPI_Queued=0,
+    SPI_Running,
+    SPI_Complete
+};
+typedef enum SPI_Job_Status_t SPI_Job_Status;
+
+struct SPI_Job_t
+{
+    volatile unsigned char *port;           // Chip select port (NULL = SPI_SS)
+    unsigned char pin;                      // Chip select pin (active LOW)
+    const unsigned char *tx;                // Transmit buffer (NULL = SPI_DUMMY)
+    unsigned char *rx;                      // Receive buffer (NULL = discard)
+    unsigned int length;                    // Number of bytes
+    void (*callback)(struct SPI_Job_t *job);// Called from ISR on completion (NULL = none)
+    SPI_Device *device;                     // Device (NULL = port/pin with current bus setup)
+    volatile SPI_Job_Status status;         // Transaction status
+};
+typedef struct SPI_Job_t SPI_Job;
+
+unsigned char spi_init(SPI_Mode operation, SPI_Direction direction, SPI_Clockmode mode, unsigned long frequency);
+  SPI_Divider spi_divider(unsigned long frequency);
          void spi_disable(void);
          void spi_select(SPI_Select mode);
    SPI_Select spi_slave_select(void);
+         void spi_device_init(SPI_Device *device, volatile unsigned char *port, unsigned char pin, SPI_Clockmode mode, SPI_Divider divider, SPI_Direction direction);
+         void spi_device_select(SPI_Device *device);
+         void spi_device_release(SPI_Device *device);
 
 #ifndef SPI_SPIE
     unsigned char spi_transfer(unsigned char data);
        SPI_Status spi_slave_transfer(unsigned char *data);
+             void spi_write_block(const unsigned char *data, unsigned int length);
+             void spi_read_block(unsigned char *data, unsigned int length);
+             void spi_exchange(const unsigned char *tx, unsigned char *rx, unsigned int length);
+#else
+    unsigned char spi_queue(SPI_Job *job);
+    unsigned char spi_busy(void);
+    unsigned char spi_slave_write(const unsigned char *data, unsigned char length);
+    unsigned char spi_slave_read(unsigned char *data, unsigned char length);
+             void spi_slave_response(unsigned char data);
+        SPI_Frame spi_slave_frame(unsigned char *length);
 #endif
 
 #endif /* SPI_H_ */
\ No newline at end of file
@@ -0,0 +1,22 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: PC (host test)
+ *    Hardware: -
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Mock of <avr/interrupt.h> for the
+ *   spi host test (SREG is a variable)
+ * -----------------------------------------
+ */
+
+#ifndef AVR_INTERRUPT_MOCK_H_
+#define AVR_INTERRUPT_MOCK_H_
+
+#define sei()
+#define cli()
+
+#endif /* AVR_INTERRUPT_MOCK_H_ */
\ No newline at end of file
@@ -0,0 +1,51 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: PC (host test)
+ *    Hardware: -
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Register mock of <avr/io.h> for the
+ *   spi host test (ATmega16 bit positions)
+ * -----------------------------------------
+ */
+
+#ifndef AVR_IO_MOCK_H_
+#define AVR_IO_MOCK_H_
+
+// Registers are plain variables (defined in spi_test.c)
+extern volatile unsigned char SPCR;
+extern volatile unsigned char SPSR;
+extern volatile unsigned char SPDR;
+extern volatile unsigned char DDRB;
+extern volatile unsigned char PORTB;
+extern volatile unsigned char PINB;
+extern volatile unsigned char SREG;
+
+// SPCR
+#define SPIE 7
+#define SPE  6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+
+// SPSR (spi.h uses SPI2X as configuration switch)
+#define SPIF 7
+#define WCOL 6
+#undef SPI2X
+#define SPI2X 0
+
+// PORTB
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+
+#endif /* AVR_IO_MOCK_H_ */
\ No newline at end of file
@@ -0,0 +1,138 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: PC (host test)
+ *    Hardware: -
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Register level test of spi_init() and
+ *   spi_divider() (SPCR/SPSR/DDRB)
+ *
+ *   Build and run from library/spi:
+ *   cc -std=gnu99 -funsigned-char -Itest
+ *      -o spi_test test/spi_test.c spi.c
+ *   ./spi_test
+ * -----------------------------------------
+ */
+
+#include <stdio.h>
+
+#include "../spi.h"
+
+// Mocked registers
+volatile unsigned char SPCR;
+volatile unsigned char SPSR;
+volatile unsigned char SPDR;
+volatile unsigned char DDRB;
+volatile unsigned char PORTB;
+volatile unsigned char PINB;
+volatile unsigned char SREG;
+
+static unsigned int test_count;
+static unsigned int test_failed;
+
+#define CHECK(condition, ...)                       \
+    do                                              \
+    {                                               \
+        test_count++;                               \
+        if(!(condition))                            \
+        {                                           \
+            test_failed++;                          \
+            printf("FAIL %s: ", #condition);        \
+            printf(__VA_ARGS__);                    \
+            printf("\n");                           \
+        }                                           \
+    } while(0)
+
+// Expected setup for divider 2^(i + 1)
+//
+// +---------+------+------+-------+
+// | Divider | SPR1 | SPR0 | SPI2X |
+// +---------+------+------+-------+
+// |       2 |    0 |    0 |     1 |
+// |       4 |    0 |    0 |     0 |
+// |       8 |    0 |    1 |     1 |
+// |      16 |    0 |    1 |     0 |
+// |      32 |    1 |    0 |     1 |
+// |      64 |    1 |    0 |     0 |
+// |     128 |    1 |    1 |     0 |
+// +---------+------+------+-------+
+static const unsigned char expect_spr[7]   = { 0, 0, 1, 1, 2, 2, 3 };
+static const unsigned char expect_spi2x[7] = { 1, 0, 1, 0, 1, 0, 0 };
+
+//  +---------------------------------------------------------------+
+//  |           Check registers after spi_init()                    |
+//  +---------------------------------------------------------------+
+//  | Parameter:    operation   ->  SPI_Master/SPI_Slave            |
+//  |               direction   ->  SPI_MSB/SPI_LSB                 |
+//  |               mode        ->  SPI_Mode0 - SPI_Mode3           |
+//  |               frequency   ->  SCK frequency in Hz             |
+//  |               divider     ->  Expected divider index (0 - 6)  |
+//  +---------------------------------------------------------------+
+static void check_init(SPI_Mode operation, SPI_Direction direction, SPI_Clockmode mode, unsigned long frequency, unsigned char divider)
+{
+    SPCR = 0xFF;    // Garbage from previous setup
+    SPSR = 0xFF;
+    DDRB = 0x00;
+    
+    unsigned char status = spi_init(operation, direction, mode, frequency);
+    
+    unsigned char spcr = SPCR;
+    unsigned char spsr = SPSR;
+    
+    const char *name = (operation == SPI_Master) ? "master" : "slave";
+    
+    CHECK(spcr & (1<<SPE), "%s mode %u %lu Hz: SPE", name, mode, frequency);
+    CHECK(!(spcr & (1<<SPIE)), "%s mode %u %lu Hz: SPIE", name, mode, frequency);
+    CHECK(!!(spcr & (1<<MSTR)) == (operation == SPI_Master), "%s mode %u %lu Hz: MSTR", name, mode, frequency);
+    CHECK(!!(spcr & (1<<DORD)) == (direction == SPI_LSB), "%s mode %u %lu Hz: DORD", name, mode, frequency);
+    CHECK(!!(spcr & (1<<CPOL)) == ((mode>>1) & 0x01), "%s mode %u %lu Hz: CPOL", name, mode, frequency);
+    CHECK(!!(spcr & (1<<CPHA)) == (mode & 0x01), "%s mode %u %lu Hz: CPHA", name, mode, frequency);
+    CHECK((spcr & ((1<<SPR1) | (1<<SPR0))) == expect_spr[divider], "%s mode %u %lu Hz: SPR = %u, expected %u", name, mode, frequency, spcr & 0x03, expect_spr[divider]);
+    CHECK((spsr & (1<<SPI2X)) == expect_spi2x[divider], "%s mode %u %lu Hz: SPI2X = %u, expected %u", name, mode, frequency, spsr & 0x01, expect_spi2x[divider]);
+    CHECK((DDRB & ((1<<SPI_SCK) | (1<<SPI_MOSI) | (1<<SPI_SS))) == ((1<<SPI_SCK) | (1<<SPI_MOSI) | (1<<SPI_SS)), "%s mode %u %lu Hz: DDRB = 0x%02X", name, mode, frequency, DDRB);
+    
+    // Mocked SPCR never clears MSTR (no master abort)
+    CHECK((operation != SPI_Master) || (status == 0x00), "%s mode %u %lu Hz: return 0x%02X", name, mode, frequency, status);
+}
+
+int main(void)
+{
+    // Every mode x divider x master/slave x bit order (exact frequencies)
+    for(unsigned char operation=0; operation < 2; operation++)
+    {
+        for(unsigned char direction=0; direction < 2; direction++)
+        {
+            for(unsigned char mode=0; mode < 4; mode++)
+            {
+                for(unsigned char i=0; i < 7; i++)
+                    check_init((SPI_Mode)operation, (SPI_Direction)direction, (SPI_Clockmode)mode, F_CPU>>(i + 1), i);
+            }
+        }
+    }
+    
+    // Frequencies between two dividers select the slower one
+    for(unsigned char i=1; i < 7; i++)
+        check_init(SPI_Master, SPI_MSB, SPI_Mode3, (F_CPU>>i) - 1, i);
+    
+    // Out of range frequencies
+    check_init(SPI_Master, SPI_MSB, SPI_Mode0, F_CPU, 0);           // Faster than F_CPU/2
+    check_init(SPI_Master, SPI_MSB, SPI_Mode0, 1000UL, 6);          // Slower than F_CPU/128
+    
+    // spi_divider() return values
+    CHECK(spi_divider(F_CPU / 2) == SPI_Div2, "spi_divider(F_CPU/2)");
+    CHECK(spi_divider(F_CPU / 4) == SPI_Div4, "spi_divider(F_CPU/4)");
+    CHECK(spi_divider(F_CPU / 8) == SPI_Div8, "spi_divider(F_CPU/8)");
+    CHECK(spi_divider(F_CPU / 16) == SPI_Div16, "spi_divider(F_CPU/16)");
+    CHECK(spi_divider(F_CPU / 32) == SPI_Div32, "spi_divider(F_CPU/32)");
+    CHECK(spi_divider(F_CPU / 64) == SPI_Div64, "spi_divider(F_CPU/64)");
+    CHECK(spi_divider(F_CPU / 128) == SPI_Div128, "spi_divider(F_CPU/128)");
+    CHECK(spi_divider(1000000UL) == SPI_Div16, "spi_divider(1 MHz)");
+    
+    printf("%u checks, %u failed\n", test_count, test_failed);
+    
+    return test_failed ? 1 : 0;
+}
\ No newline at end of file
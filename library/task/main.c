@@ -0,0 +1,85 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for event driven tasks with
+ *   task library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+
+// User libraries
+#include "../tick/tick.h"
+#include "task.h"
+
+// Task numbers (= priority)
+#define TASK_BUTTON 0
+#define TASK_LED    1
+
+// Events
+#define EVENT_POLL    TASK_EVENT0
+#define EVENT_PRESSED TASK_EVENT0
+#define EVENT_BLINK   TASK_EVENT1
+
+// Software timer callbacks (called from tick ISR)
+void poll_timer(unsigned char timer)
+{
+    task_post(TASK_BUTTON, EVENT_POLL);
+}
+
+void blink_timer(unsigned char timer)
+{
+    task_post(TASK_LED, EVENT_BLINK);
+}
+
+// Button task: Reads S0 every 20 ms (debounced by sampling)
+void button_task(unsigned char events)
+{
+    static unsigned char last = 0;
+    
+    unsigned char state = !(PINA & (1<<PA0));
+    
+    if(state && !last)
+        task_post(TASK_LED, EVENT_PRESSED);
+    
+    last = state;
+}
+
+// LED task: Blinks PORTC(0) and counts S0 on PORTC(7:4)
+void led_task(unsigned char events)
+{
+    if(events & EVENT_BLINK)
+        PORTC ^= (1<<PC0);
+    
+    if(events & EVENT_PRESSED)
+        PORTC = (0x0F & PORTC) + 0x10;
+}
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    DDRA = 0x00;    // Set PORT as input
+    PORTA = 0x0F;   // Enable pullup resistors
+    
+    tick_init();    // 1 ms system tick
+    
+    task_create(TASK_BUTTON, button_task);
+    task_create(TASK_LED, led_task);
+    
+    tick_timer_start(20, TICK_Periodic, poll_timer);
+    tick_timer_start(500, TICK_Periodic, blink_timer);
+    
+    // Execute tasks, sleep while nothing is to do
+    task_run();
+}   // End of main
\ No newline at end of file
@@ -0,0 +1,169 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for task library
+ *   (cooperative event scheduler)
+ * -----------------------------------------
+ */
+
+#include "task.h"
+
+static void (*task_table[TASK_COUNT])(unsigned char events);   // Task functions
+static unsigned char task_pending[TASK_COUNT];                  // Events not yet handled
+
+// Event queue (written by task_post(), read by scheduler)
+static volatile unsigned char task_queue[TASK_QUEUE_SIZE][2];
+static volatile unsigned char task_head;
+static volatile unsigned char task_tail;
+
+//  +---------------------------------------------------------------+
+//  |                   TASK create                                 |
+//  +---------------------------------------------------------------+
+//  | Parameter:    task        ->  Task number/priority            |
+//  |                               (0 = highest priority)          |
+//  |               function    ->  Task function, called with the  |
+//  |                               events posted since last call   |
+//  |                                                               |
+//  |    Return:    0x00        ->  Task created                    |
+//  |               0xFF        ->  Task number in use/invalid      |
+//  +---------------------------------------------------------------+
+unsigned char task_create(unsigned char task, void (*function)(unsigned char events))
+{
+    if((task >= TASK_COUNT) || (task_table[task] != NULL) || (function == NULL))
+        return 0xFF;
+    
+    task_pending[task] = 0;
+    task_table[task] = function;
+    
+    return 0x00;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TASK delete                                 |
+//  +---------------------------------------------------------------+
+//  | Parameter:    task        ->  Task number                     |
+//  +---------------------------------------------------------------+
+void task_delete(unsigned char task)
+{
+    if(task < TASK_COUNT)
+        task_table[task] = NULL;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TASK post events                            |
+//  +---------------------------------------------------------------+
+//  | Parameter:    task        ->  Task number                     |
+//  |               events      ->  Event bits (TASK_EVENT0-7)      |
+//  |                                                               |
+//  |    Return:    0x00        ->  Events posted                   |
+//  |               0xFF        ->  Queue full                      |
+//  +---------------------------------------------------------------+
+//  | Can be called from ISR and tasks. Several producers share     |
+//  | the queue, so posting is interrupt-locked for a few cycles.   |
+//  | Only the scheduler (single consumer) takes entries without    |
+//  | a lock.                                                       |
+//  +---------------------------------------------------------------+
+unsigned char task_post(unsigned char task, unsigned char events)
+{
+    unsigned char status = 0xFF;
+    
+    // Several producers share the head (no effect inside ISR)
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned char head = task_head;
+    unsigned char next = (head + 1) & (TASK_QUEUE_SIZE - 1);
+    
+    if(next != task_tail)
+    {
+        task_queue[head][0] = task;
+        task_queue[head][1] = events;
+        task_head = next;   // Publish entry after it is written
+        
+        status = 0x00;
+    }
+    
+    SREG = sreg;
+    
+    return status;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TASK run highest priority task              |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x00        ->  No task ready                   |
+//  |               0x01        ->  Task executed                   |
+//  +---------------------------------------------------------------+
+//  | Tasks run to completion, a task that is posted while another  |
+//  | one runs is executed after it (highest priority first).       |
+//  +---------------------------------------------------------------+
+unsigned char task_dispatch(void)
+{
+    // Move queued events to tasks
+    unsigned char tail = task_tail;
+    
+    while(tail != task_head)
+    {
+        unsigned char task = task_queue[tail][0];
+        
+        if(task < TASK_COUNT)
+            task_pending[task] |= task_queue[tail][1];
+        
+        tail = (tail + 1) & (TASK_QUEUE_SIZE - 1);
+        task_tail = tail;   // Release entry after it is read
+    }
+    
+    // Execute task with highest priority
+    for(unsigned char task=0; task < TASK_COUNT; task++)
+    {
+        unsigned char events = task_pending[task];
+        
+        if(events && (task_table[task] != NULL))
+        {
+            task_pending[task] = 0;
+            task_table[task](events);
+            
+            return 0x01;
+        }
+    }
+    return 0x00;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TASK scheduler                              |
+//  +---------------------------------------------------------------+
+//  | Executes ready tasks, the controller sleeps (TASK_SLEEP)      |
+//  | until the next interrupt if no task is ready. Never returns.  |
+//  +---------------------------------------------------------------+
+void task_run(void)
+{
+    set_sleep_mode(TASK_SLEEP);
+    sei();
+    
+    while(1)
+    {
+        if(task_dispatch())
+            continue;
+        
+        // Sleep only if no event was posted in the meantime,
+        // sei() delays interrupts until sleep is executed
+        cli();
+        
+        if(task_tail == task_head)
+        {
+            sleep_enable();
+            sei();
+            sleep_cpu();
+            sleep_disable();
+        }
+        
+        sei();
+    }
+}
\ No newline at end of file
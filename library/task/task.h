@@ -0,0 +1,66 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for task library
+ *   (cooperative event scheduler)
+ * -----------------------------------------
+ */
+
+#ifndef TASK_H_
+#define TASK_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+// Definition of TASK parameters
+
+#ifndef TASK_COUNT          // Number of tasks (task number = priority, 0 = highest)
+    #define TASK_COUNT 8
+#endif
+
+#ifndef TASK_QUEUE_SIZE     // Event queue size (2^n)
+    #define TASK_QUEUE_SIZE 16
+#endif
+
+#ifndef TASK_SLEEP          // Sleep mode if no task is ready (SLEEP_MODE_IDLE keeps timers/UART running)
+    #define TASK_SLEEP SLEEP_MODE_IDLE
+#endif
+
+#if (TASK_QUEUE_SIZE & (TASK_QUEUE_SIZE - 1)) || (TASK_QUEUE_SIZE > 128)
+    #error "TASK_QUEUE_SIZE must be a power of 2 (max. 128)"
+#endif
+
+#if TASK_COUNT > 32
+    #error "TASK_COUNT too large (max. 32)"
+#endif
+
+// Events (bit mask, up to 8 events per task)
+#define TASK_EVENT0 0x01
+#define TASK_EVENT1 0x02
+#define TASK_EVENT2 0x04
+#define TASK_EVENT3 0x08
+#define TASK_EVENT4 0x10
+#define TASK_EVENT5 0x20
+#define TASK_EVENT6 0x40
+#define TASK_EVENT7 0x80
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+unsigned char task_create(unsigned char task, void (*function)(unsigned char events));
+         void task_delete(unsigned char task);
+unsigned char task_post(unsigned char task, unsigned char events);
+unsigned char task_dispatch(void);
+         void task_run(void);
+
+#endif /* TASK_H_ */
\ No newline at end of file
@@ -0,0 +1,63 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for system time and software
+ *   timers with tick library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+
+// User libraries
+#include "tick.h"
+
+// Software timer callback (called from tick ISR)
+void blink(unsigned char timer)
+{
+    PORTC ^= (1<<PC0);  // Toggle LED every 500 ms
+}
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    DDRA = 0x00;    // Set PORT as input
+    PORTA = 0x0F;   // Enable pullup resistors
+    
+    tick_init();    // 1 ms system tick
+    
+    tick_timer_start(500, TICK_Periodic, blink);
+    
+    unsigned char flash = 0xFF;     // One-shot timer of S0
+    unsigned long start = tick_millis();
+    
+    while (1) 
+    {
+        // Running seconds on LEDs PORTC(7:4) without blocking delay
+        if(tick_elapsed(start, 1000))
+        {
+            start += 1000;
+            PORTC = (0x0F & PORTC) + 0x10;
+        }
+        
+        // S0 switches on LED PORTC(1) for 2 s
+        if(!(PINA & (1<<PA0)) && !tick_timer_active(flash))
+        {
+            PORTC |= (1<<PC1);
+            flash = tick_timer_start(2000, TICK_Oneshot, NULL);
+        }
+        
+        if(!tick_timer_active(flash))
+            PORTC &= ~(1<<PC1);
+    }   // End of loop
+}   // End of main
\ No newline at end of file
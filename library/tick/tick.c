@@ -0,0 +1,312 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for tick library
+ *   (system time and software timers)
+ * -----------------------------------------
+ */
+
+#include "tick.h"
+
+#if TICK_TIMER == 0
+    #define TICK_TCCR   TCCR0
+    #define TICK_TCNT   TCNT0
+    #define TICK_OCR    OCR0
+    #define TICK_WGM    (1<<WGM01)
+    #define TICK_OCIE   (1<<OCIE0)
+    #define TICK_OCF    (1<<OCF0)
+    #define TICK_vect   TIMER0_COMP_vect
+#else
+    #define TICK_TCCR   TCCR2
+    #define TICK_TCNT   TCNT2
+    #define TICK_OCR    OCR2
+    #define TICK_WGM    (1<<WGM21)
+    #define TICK_OCIE   (1<<OCIE2)
+    #define TICK_OCF    (1<<OCF2)
+    #define TICK_vect   TIMER2_COMP_vect
+#endif
+
+struct TICK_Timer_t
+{
+    unsigned long remaining;                // Ticks until expiry (0 = stopped)
+    unsigned long period;                   // Reload ticks (0 = one-shot)
+    void (*callback)(unsigned char timer);  // Called from ISR on expiry (NULL = none)
+};
+typedef struct TICK_Timer_t TICK_Timer;
+
+static volatile unsigned long tick_ticks;       // Ticks since tick_init()
+static volatile unsigned long tick_ms;          // Milliseconds since tick_init()
+static volatile TICK_Timer tick_timers[TICK_TIMERS];
+
+#if (TICK_US % 1000UL) != 0
+    static volatile unsigned int tick_us;       // Microseconds not yet added to tick_ms
+#endif
+
+#if TICK_FRACTION != 0
+    static unsigned int tick_fraction;          // Accumulated remaining cycles
+#endif
+
+//  +---------------------------------------------------------------+
+//  |                   TICK initialization                         |
+//  +---------------------------------------------------------------+
+//  | Timer is set up in CTC mode with compare match interrupt.     |
+//  | Global interrupts are enabled.                                |
+//  +---------------------------------------------------------------+
+void tick_init(void)
+{
+    TICK_TCCR = 0x00;                   // Stop timer
+    TIMSK &= ~TICK_OCIE;
+    
+    tick_ticks = 0;
+    tick_ms = 0;
+    
+    #if (TICK_US % 1000UL) != 0
+        tick_us = 0;
+    #endif
+    
+    #if TICK_FRACTION != 0
+        tick_fraction = 0;
+    #endif
+    
+    for(unsigned char i=0; i < TICK_TIMERS; i++)
+        tick_timers[i].remaining = 0;
+    
+    TICK_TCNT = 0;
+    TICK_OCR = (unsigned char)(TICK_COUNTS - 1);
+    TIFR = TICK_OCF;                    // Reset pending compare match
+    TIMSK |= TICK_OCIE;                 // Enable compare match interrupt
+    TICK_TCCR = TICK_WGM | TICK_CS;     // CTC mode + prescaler
+    
+    sei();
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK disable                                |
+//  +---------------------------------------------------------------+
+void tick_disable(void)
+{
+    TICK_TCCR = 0x00;
+    TIMSK &= ~TICK_OCIE;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK number of ticks                        |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x??    ->  Ticks since tick_init()             |
+//  +---------------------------------------------------------------+
+unsigned long tick_count(void)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned long ticks = tick_ticks;
+    
+    SREG = sreg;
+    
+    return ticks;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK milliseconds                           |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x??    ->  Milliseconds since tick_init()      |
+//  |                           (overflow after ~49 days)           |
+//  +---------------------------------------------------------------+
+unsigned long tick_millis(void)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned long ms = tick_ms;
+    
+    SREG = sreg;
+    
+    return ms;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK microseconds                           |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x??    ->  Microseconds since tick_init()      |
+//  |                           (overflow after ~71 minutes)        |
+//  +---------------------------------------------------------------+
+//  | Resolution is one timer count (prescaler / F_CPU). The value  |
+//  | within a tick is limited, so the time is always increasing.   |
+//  +---------------------------------------------------------------+
+unsigned long tick_micros(void)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned long ticks = tick_ticks;
+    unsigned char counts = TICK_TCNT;
+    
+    // Compare match occurred but ISR not yet executed
+    if((TIFR & TICK_OCF) && (counts < (TICK_COUNTS / 2)))
+        ticks++;
+    
+    SREG = sreg;
+    
+    unsigned long us = ((unsigned long)counts * TICK_PRESCALER) / (F_CPU / 1000000UL);
+    
+    if(us >= TICK_US)
+        us = TICK_US - 1;
+    
+    return (ticks * TICK_US) + us;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK check timeout                          |
+//  +---------------------------------------------------------------+
+//  | Parameter:    start   ->  Start time (tick_millis())          |
+//  |               ms      ->  Timeout in ms                       |
+//  |                                                               |
+//  |    Return:    0x00    ->  Timeout not elapsed                 |
+//  |               0x01    ->  Timeout elapsed                     |
+//  +---------------------------------------------------------------+
+//  | Works across the overflow of tick_millis()                    |
+//  +---------------------------------------------------------------+
+unsigned char tick_elapsed(unsigned long start, unsigned long ms)
+{
+    return ((tick_millis() - start) >= ms);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK start software timer                   |
+//  +---------------------------------------------------------------+
+//  | Parameter:    ms          ->  Time until expiry in ms         |
+//  |               mode        ->  TICK_Oneshot/TICK_Periodic      |
+//  |               callback    ->  Called from ISR on expiry       |
+//  |                               (NULL = none)                   |
+//  |                                                               |
+//  |    Return:    0x??        ->  Timer number                    |
+//  |               0xFF        ->  No free timer or time too long  |
+//  +---------------------------------------------------------------+
+//  | Callbacks are executed in the tick interrupt and have to be   |
+//  | short. A one-shot timer is free again after expiry.           |
+//  +---------------------------------------------------------------+
+unsigned char tick_timer_start(unsigned long ms, TICK_Mode mode, void (*callback)(unsigned char timer))
+{
+    // Number of ticks has to fit into 32 bit
+    if((ms / TICK_US) >= (0xFFFFFFFFUL / 1000UL))
+        return 0xFF;
+    
+    // Convert to ticks (at least one tick), whole tick periods
+    // first so ms * 1000 cannot overflow
+    unsigned long ticks = ((ms / TICK_US) * 1000UL) + ((((ms % TICK_US) * 1000UL) + (TICK_US - 1)) / TICK_US);
+    
+    if(ticks == 0)
+        ticks = 1;
+    
+    unsigned char sreg = SREG;
+    cli();
+    
+    for(unsigned char i=0; i < TICK_TIMERS; i++)
+    {
+        if(tick_timers[i].remaining == 0)
+        {
+            tick_timers[i].remaining = ticks;
+            tick_timers[i].period = (mode == TICK_Periodic) ? ticks : 0;
+            tick_timers[i].callback = callback;
+            
+            SREG = sreg;
+            return i;
+        }
+    }
+    
+    SREG = sreg;
+    return 0xFF;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK stop software timer                    |
+//  +---------------------------------------------------------------+
+//  | Parameter:    timer   ->  Timer number                        |
+//  +---------------------------------------------------------------+
+void tick_timer_stop(unsigned char timer)
+{
+    if(timer >= TICK_TIMERS)
+        return;
+    
+    unsigned char sreg = SREG;
+    cli();
+    
+    tick_timers[timer].remaining = 0;
+    
+    SREG = sreg;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK software timer running                 |
+//  +---------------------------------------------------------------+
+//  | Parameter:    timer   ->  Timer number                        |
+//  |                                                               |
+//  |    Return:    0x00    ->  Timer stopped/expired               |
+//  |               0x01    ->  Timer running                       |
+//  +---------------------------------------------------------------+
+unsigned char tick_timer_active(unsigned char timer)
+{
+    if(timer >= TICK_TIMERS)
+        return 0x00;
+    
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned char active = (tick_timers[timer].remaining != 0);
+    
+    SREG = sreg;
+    
+    return active;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TICK compare match interrupt                |
+//  +---------------------------------------------------------------+
+ISR(TICK_vect)
+{
+    // Switch between two compare values for an exact average tick
+    #if TICK_FRACTION != 0
+        tick_fraction += TICK_FRACTION;
+        
+        if(tick_fraction >= TICK_PRESCALER)
+        {
+            tick_fraction -= TICK_PRESCALER;
+            TICK_OCR = (unsigned char)(TICK_COUNTS);        // Next tick one count longer
+        }
+        else
+            TICK_OCR = (unsigned char)(TICK_COUNTS - 1);
+    #endif
+    
+    tick_ticks++;
+    
+    #if (TICK_US % 1000UL) == 0
+        tick_ms += TICK_US / 1000UL;
+    #else
+        tick_us += TICK_US;
+        
+        while(tick_us >= 1000)
+        {
+            tick_us -= 1000;
+            tick_ms++;
+        }
+    #endif
+    
+    // Software timers
+    for(unsigned char i=0; i < TICK_TIMERS; i++)
+    {
+        if(tick_timers[i].remaining && !(--tick_timers[i].remaining))
+        {
+            tick_timers[i].remaining = tick_timers[i].period;
+            
+            if(tick_timers[i].callback != NULL)
+                tick_timers[i].callback(i);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for tick library
+ *   (system time and software timers)
+ * -----------------------------------------
+ */
+
+#ifndef TICK_H_
+#define TICK_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+// Definition of TICK parameters
+
+#ifndef TICK_TIMER          // Hardware timer (0 = Timer0/2 = Timer2)
+    #define TICK_TIMER 0
+#endif
+
+#ifndef TICK_US             // Tick period in us
+    #define TICK_US 1000UL
+#endif
+
+#ifndef TICK_TIMERS         // Number of software timers
+    #define TICK_TIMERS 8
+#endif
+
+// Timer setup (F_CPU = 12 MHz)
+//
+// +-----------+---------------------+---------------------+
+// |           | Timer0              | Timer2              |
+// | TICK_US   | Prescaler | OCR     | Prescaler | OCR     |
+// +-----------+-----------+---------+-----------+---------+
+// | 100       | 8         | 149     | 8         | 149     |
+// | 500       | 64        | 92/93   | 32        | 186/187 |
+// | 1000      | 64        | 186/187 | 64        | 186/187 |
+// | 2000      | 256       | 92/93   | 128       | 186/187 |
+// +-----------+-----------+---------+-----------+---------+
+//
+// If the tick is not a multiple of the prescaler, OCR is
+// switched between two values every tick, so the average
+// tick is exact (jitter < 1 prescaler period).
+
+#define TICK_CYCLES ((F_CPU / 1000000UL) * TICK_US)     // CPU cycles per tick
+
+#if TICK_TIMER == 0
+    #if TICK_CYCLES <= 256UL
+        #define TICK_PRESCALER 1UL
+        #define TICK_CS 0x01
+    #elif TICK_CYCLES <= (256UL * 8UL)
+        #define TICK_PRESCALER 8UL
+        #define TICK_CS 0x02
+    #elif TICK_CYCLES <= (256UL * 64UL)
+        #define TICK_PRESCALER 64UL
+        #define TICK_CS 0x03
+    #elif TICK_CYCLES <= (256UL * 256UL)
+        #define TICK_PRESCALER 256UL
+        #define TICK_CS 0x04
+    #else
+        #define TICK_PRESCALER 1024UL
+        #define TICK_CS 0x05
+    #endif
+#elif TICK_TIMER == 2
+    #if TICK_CYCLES <= 256UL
+        #define TICK_PRESCALER 1UL
+        #define TICK_CS 0x01
+    #elif TICK_CYCLES <= (256UL * 8UL)
+        #define TICK_PRESCALER 8UL
+        #define TICK_CS 0x02
+    #elif TICK_CYCLES <= (256UL * 32UL)
+        #define TICK_PRESCALER 32UL
+        #define TICK_CS 0x03
+    #elif TICK_CYCLES <= (256UL * 64UL)
+        #define TICK_PRESCALER 64UL
+        #define TICK_CS 0x04
+    #elif TICK_CYCLES <= (256UL * 128UL)
+        #define TICK_PRESCALER 128UL
+        #define TICK_CS 0x05
+    #elif TICK_CYCLES <= (256UL * 256UL)
+        #define TICK_PRESCALER 256UL
+        #define TICK_CS 0x06
+    #else
+        #define TICK_PRESCALER 1024UL
+        #define TICK_CS 0x07
+    #endif
+#else
+    #error "TICK_TIMER must be 0 or 2"
+#endif
+
+#define TICK_COUNTS (TICK_CYCLES / TICK_PRESCALER)      // Timer counts per tick
+#define TICK_FRACTION (TICK_CYCLES % TICK_PRESCALER)    // Remaining cycles per tick
+
+#if (TICK_COUNTS + ((TICK_FRACTION) ? 1 : 0)) > 256UL
+    #error "TICK_US too long for an 8 bit timer"
+#endif
+
+#if ((F_CPU % 1000000UL) != 0) || (TICK_US < 10)
+    #error "F_CPU must be a multiple of 1 MHz and TICK_US at least 10 us"
+#endif
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+enum TICK_Mode_t
+{
+    TICK_Oneshot=0,
+    TICK_Periodic
+};
+typedef enum TICK_Mode_t TICK_Mode;
+
+         void tick_init(void);
+         void tick_disable(void);
+unsigned long tick_count(void);
+unsigned long tick_millis(void);
+unsigned long tick_micros(void);
+unsigned char tick_elapsed(unsigned long start, unsigned long ms);
+
+unsigned char tick_timer_start(unsigned long ms, TICK_Mode mode, void (*callback)(unsigned char timer));
+         void tick_timer_stop(unsigned char timer);
+unsigned char tick_timer_active(unsigned char timer);
+
+#endif /* TICK_H_ */
\ No newline at end of file
@@ -0,0 +1,83 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Sample for playing melodies with
+ *   tone library
+ * -----------------------------------------
+ */ 
+
+#define F_CPU 12000000UL    // System clock (required for delay)
+
+// System libraries
+#include <avr/io.h>
+
+// User libraries
+#include "../tick/tick.h"
+#include "tone.h"
+
+// Melody (stored in flash)
+const TONE_Step melody[] PROGMEM =
+{
+    { TONE_NOTE(TONE_C, 5), 200 },
+    { TONE_NOTE(TONE_E, 5), 200 },
+    { TONE_NOTE(TONE_G, 5), 200 },
+    { TONE_NOTE(TONE_C, 6), 400 },
+    { TONE_REST,            200 },
+    { TONE_NOTE(TONE_G, 5), 200 },
+    { TONE_NOTE(TONE_C, 6), 600 },
+    TONE_END
+};
+
+// Alarm (repeated until stopped)
+const TONE_Step alarm[] PROGMEM =
+{
+    { TONE_NOTE(TONE_A, 5), 150 },
+    { TONE_NOTE(TONE_E, 5), 150 },
+    TONE_END
+};
+
+// Software timer callback (called from tick ISR every ms)
+void tone_timer(unsigned char timer)
+{
+    tone_update();
+}
+
+int main(void)
+{
+    // Port setup
+    DDRC = 0xFF;    // Set PORT as output
+    DDRA = 0x00;    // Set PORT as input
+    PORTA = 0x0F;   // Enable pullup resistors
+    
+    tone_init();    // Speaker on OC1A (PD5)
+    tick_init();    // 1 ms system tick
+    
+    tick_timer_start(TONE_TICK, TICK_Periodic, tone_timer);
+    
+    unsigned long start = tick_millis();
+    
+    while (1) 
+    {
+        // S0: Play melody once, S1: Start alarm, S2: Stop
+        if(!(PINA & (1<<PA0)) && !tone_busy())
+            tone_melody(melody, 0);
+        else if(!(PINA & (1<<PA1)) && !tone_busy())
+            tone_melody(alarm, 1);
+        else if(!(PINA & (1<<PA2)))
+            tone_stop();
+        
+        // Main loop keeps running while the melody is played
+        if(tick_elapsed(start, 100))
+        {
+            start += 100;
+            PORTC++;
+        }
+    }
+}   // End of main
\ No newline at end of file
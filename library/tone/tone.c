@@ -0,0 +1,273 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Function file for tone library
+ *   (notes and non-blocking melodies)
+ * -----------------------------------------
+ */
+
+#include "tone.h"
+
+// Timer clocks (prescaler 1) per half period of a note in octave 0,
+// calculated from the octave 4 frequency in mHz:
+//
+//              f_CPU           f_CPU * 16
+// counts = ------------ = -----------------
+//           2 * f_oct0      2 * f_oct4
+//
+#define TONE_COUNTS(mhz) ((unsigned long)((((unsigned long long)F_CPU * 8000ULL) + ((mhz)>>1)) / (mhz)))
+
+static const unsigned long tone_table[12] PROGMEM =
+{
+    TONE_COUNTS(261626UL),  // C4   261.626 Hz
+    TONE_COUNTS(277183UL),  // C#4  277.183 Hz
+    TONE_COUNTS(293665UL),  // D4   293.665 Hz
+    TONE_COUNTS(311127UL),  // D#4  311.127 Hz
+    TONE_COUNTS(329628UL),  // E4   329.628 Hz
+    TONE_COUNTS(349228UL),  // F4   349.228 Hz
+    TONE_COUNTS(369994UL),  // F#4  369.994 Hz
+    TONE_COUNTS(391995UL),  // G4   391.995 Hz
+    TONE_COUNTS(415305UL),  // G#4  415.305 Hz
+    TONE_COUNTS(440000UL),  // A4   440.000 Hz
+    TONE_COUNTS(466164UL),  // A#4  466.164 Hz
+    TONE_COUNTS(493883UL)   // B4   493.883 Hz
+};
+
+// Melody sequencer (tone_update() in ISR)
+static const TONE_Step * volatile tone_start;       // First step (NULL = no melody)
+static const TONE_Step * volatile tone_step;        // Next step
+static volatile unsigned int tone_remaining;        // Time left of current step in ms
+static volatile unsigned char tone_repeat;
+
+//  +---------------------------------------------------------------+
+//  |                   TONE output half period                     |
+//  +---------------------------------------------------------------+
+//  | Parameter:    counts      ->  Timer clocks (prescaler 1) per  |
+//  |                               half period (0 = silence)       |
+//  +---------------------------------------------------------------+
+//  | Timer1 in CTC mode toggles OC1A on compare match:             |
+//  |                                                               |
+//  |                 f_CPU                                         |
+//  | f = ------------------------                                  |
+//  |      2 * N * (1 + OCR1A)                                      |
+//  +---------------------------------------------------------------+
+static void tone_output(unsigned long counts)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    TCCR1B = (1<<WGM12);    // Stop timer
+    
+    if(!counts)
+    {
+        TCCR1A = 0x00;          // Disconnect OC1A
+        PORTD &= ~(1<<PD5);
+        
+        SREG = sreg;
+        return;
+    }
+    
+    // Prescaler 1/8/64/256/1024 -> largest OCR1A (best resolution)
+    static const unsigned char shift[5] = { 0, 3, 6, 8, 10 };
+    unsigned char cs = 1;
+    
+    while((cs < 5) && (((counts + ((1UL<<shift[cs - 1])>>1))>>shift[cs - 1]) > 65536UL))
+        cs++;
+    
+    counts = (counts + ((1UL<<shift[cs - 1])>>1))>>shift[cs - 1];
+    
+    if(counts > 65536UL)
+        counts = 65536UL;
+    
+    // OCR1A is not buffered in CTC mode -> restart counter
+    OCR1A = (unsigned int)(counts - 1);
+    TCNT1 = 0;
+    TCCR1A = (1<<COM1A0);       // Toggle OC1A
+    TCCR1B = (1<<WGM12) | cs;
+    
+    SREG = sreg;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE note to timer clocks                   |
+//  +---------------------------------------------------------------+
+//  | Parameter:    note        ->  TONE_NOTE()/TONE_REST           |
+//  |                                                               |
+//  |    Return:    0x????????  ->  Timer clocks per half period    |
+//  |                               (0 = rest/invalid note)         |
+//  +---------------------------------------------------------------+
+static unsigned long tone_counts(unsigned char note)
+{
+    if(note >= TONE_NOTE(0, 9))
+        return 0;
+    
+    unsigned char octave = note / 12;
+    unsigned long counts = pgm_read_dword(&tone_table[note % 12]);
+    
+    // Every octave halves the period
+    return (counts + ((1UL<<octave)>>1))>>octave;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE initialization                         |
+//  +---------------------------------------------------------------+
+//  | Speaker/buzzer has to be connected to OC1A (PD5).             |
+//  +---------------------------------------------------------------+
+void tone_init(void)
+{
+    DDRD |= (1<<PD5);
+    tone_stop();
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE play note                              |
+//  +---------------------------------------------------------------+
+//  | Parameter:    note        ->  TONE_NOTE(TONE_?, 0-8)          |
+//  +---------------------------------------------------------------+
+//  | Note is played until tone_stop() is called. A running melody  |
+//  | is stopped.                                                   |
+//  +---------------------------------------------------------------+
+void tone_play(unsigned char note)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    tone_start = NULL;
+    tone_output(tone_counts(note));
+    
+    SREG = sreg;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE play frequency                         |
+//  +---------------------------------------------------------------+
+//  | Parameter:    frequency   ->  Frequency in Hz (0 = silence)   |
+//  +---------------------------------------------------------------+
+void tone_frequency(unsigned int frequency)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    tone_start = NULL;
+    
+    if(!frequency)
+        tone_output(0);
+    else
+        tone_output((F_CPU + frequency) / (2UL * frequency));
+    
+    SREG = sreg;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE stop                                   |
+//  +---------------------------------------------------------------+
+void tone_stop(void)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    tone_start = NULL;
+    tone_output(0);
+    
+    SREG = sreg;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE start melody                           |
+//  +---------------------------------------------------------------+
+//  | Parameter:    melody      ->  Steps in flash (PROGMEM),       |
+//  |                               terminated with TONE_END        |
+//  |               repeat      ->  0 = play once                   |
+//  |                               1 = repeat until tone_stop()    |
+//  +---------------------------------------------------------------+
+//  | Returns immediately, the melody is played by tone_update().   |
+//  +---------------------------------------------------------------+
+void tone_melody(const TONE_Step *melody, unsigned char repeat)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    tone_step = melody;
+    tone_remaining = 0;         // Start with next tone_update()
+    tone_repeat = repeat;
+    tone_start = melody;
+    
+    SREG = sreg;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE melody status                          |
+//  +---------------------------------------------------------------+
+//  |    Return:    0x00        ->  No melody playing               |
+//  |               0x01        ->  Melody playing                  |
+//  +---------------------------------------------------------------+
+unsigned char tone_busy(void)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned char busy = (tone_start != NULL);
+    
+    SREG = sreg;
+    
+    return busy;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TONE sequencer                              |
+//  +---------------------------------------------------------------+
+//  | Has to be called every TONE_TICK ms (e.g. from a timer        |
+//  | interrupt).                                                   |
+//  +---------------------------------------------------------------+
+void tone_update(void)
+{
+    if(tone_start == NULL)
+        return;
+    
+    // Current step not finished
+    if(tone_remaining > TONE_TICK)
+    {
+        tone_remaining -= TONE_TICK;
+        
+        // Short silence between two notes
+        if(tone_remaining <= TONE_GAP)
+            tone_output(0);
+        
+        return;
+    }
+    
+    unsigned int duration = pgm_read_word(&tone_step->duration);
+    
+    // End of melody
+    if(!duration)
+    {
+        if(!tone_repeat)
+        {
+            tone_start = NULL;
+            tone_output(0);
+            return;
+        }
+        
+        tone_step = tone_start;
+        duration = pgm_read_word(&tone_step->duration);
+        
+        // Empty melody
+        if(!duration)
+        {
+            tone_start = NULL;
+            return;
+        }
+    }
+    
+    tone_output(tone_counts(pgm_read_byte(&tone_step->note)));
+    
+    tone_remaining = duration;
+    tone_step++;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/* -----------------------------------------
+ * G.Raf^engineering
+ * www.sunriax.at
+ * -----------------------------------------
+ *    Platform: Megacard/STK500/STK600
+ *    Hardware: ATmega??-????
+ * -----------------------------------------
+ *     Version: 2.0 Release
+ *      Author: G.Raf
+ * Description:
+ *   Header file for tone library
+ *   (notes and non-blocking melodies)
+ * -----------------------------------------
+ */
+
+#ifndef TONE_H_
+#define TONE_H_
+
+#ifndef F_CPU               // System clock
+    #define F_CPU 12000000UL
+#endif
+
+// Definition of TONE parameters
+
+#ifndef TONE_TICK           // Interval of tone_update() calls in ms
+    #define TONE_TICK 1
+#endif
+
+#ifndef TONE_GAP            // Silence at the end of every melody note in ms
+    #define TONE_GAP 10
+#endif
+
+// Notes (semitone of an octave)
+#define TONE_C  0
+#define TONE_CS 1
+#define TONE_D  2
+#define TONE_DS 3
+#define TONE_E  4
+#define TONE_F  5
+#define TONE_FS 6
+#define TONE_G  7
+#define TONE_GS 8
+#define TONE_A  9
+#define TONE_AS 10
+#define TONE_B  11
+
+#define TONE_NOTE(note, octave) ((unsigned char)(((octave) * 12) + (note)))    // Octave 0-8 (A4 = 440 Hz)
+#define TONE_REST 0xFF                                                          // Pause
+#define TONE_END { TONE_REST, 0 }                                               // End of melody
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+struct TONE_Step_t
+{
+    unsigned char note;     // TONE_NOTE() or TONE_REST
+    unsigned int duration;  // Duration in ms (0 = end of melody)
+};
+
+typedef struct TONE_Step_t TONE_Step;
+
+         void tone_init(void);
+         void tone_play(unsigned char note);
+         void tone_frequency(unsigned int frequency);
+         void tone_stop(void);
+         void tone_melody(const TONE_Step *melody, unsigned char repeat);
+unsigned char tone_busy(void);
+         void tone_update(void);
+
+#endif /* TONE_H_ */
\ No newline at end of file
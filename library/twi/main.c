@@ -68,11 +68,8 @@ int main(void)
         twi_init(TWI_Master);
         
         // EEPROM WRITE routine
-        twi_start();
-        twi_address(SLAVE_ADDR, TWI_Write);
-        twi_set(EEPROM_ADDR);
-        twi_set(EEPROM_DATA);
-        twi_stop();
+        // START, SLA+W, EEPROM_ADDR, EEPROM_DATA, STOP
+        twi_write_reg(SLAVE_ADDR, EEPROM_ADDR, EEPROM_DATA);
         _delay_ms(5);
         
         while(1)
@@ -80,13 +77,9 @@ int main(void)
             unsigned char data;
             
             // EEPROM READ routine
-            twi_start();
-            twi_address(SLAVE_ADDR, TWI_Write);
-            twi_set(EEPROM_ADDR);
-            twi_start();
-            twi_address(SLAVE_ADDR, TWI_Read);
-            twi_get(&data, TWI_NACK);
-            twi_stop();
+            // START, SLA+W, EEPROM_ADDR, REPEATED START, SLA+R, data (NACK), STOP
+            if(twi_read_regs(SLAVE_ADDR, EEPROM_ADDR, &data, 1) != TWI_None)
+                continue;
             
             // Check if data written to EEPROM is same as data that was red
             if(EEPROM_DATA == data)
@@ -14,10 +14,35 @@
 
 #include "twi.h"
 
+#ifdef TWI_TWIE
+    static TWI_Job * volatile twi_jobs[TWI_QUEUE_SIZE];   // Transaction queue
+    static volatile unsigned char twi_head;             // Next free queue entry
+    static volatile unsigned char twi_tail;             // Running transaction
+    static volatile unsigned char twi_count;            // Queued transactions
+    static volatile unsigned char twi_active;           // Bus owned by the queue
+    static volatile unsigned int twi_index;             // Byte index of running phase
+    static volatile unsigned char twi_listen;           // TWEA if own slave address is answered
+    
+    static volatile unsigned char *twi_map;             // Slave register map
+    static unsigned char twi_map_size;                  // Number of registers
+    static unsigned char twi_map_first;                 // First writable register
+    static unsigned char twi_map_last;                  // Last writable register
+    static void (*twi_map_callback)(unsigned char address);
+    static volatile unsigned char twi_pointer;          // Register address pointer
+    static volatile unsigned char twi_pointer_set;      // Next received byte is data (pointer received)
+    static volatile unsigned char twi_slave_busy;       // Addressed as slave
+    static unsigned char twi_snapshot[TWI_SNAPSHOT];    // Registers copied at SLA+R
+    static unsigned char twi_snapshot_index;            // Next byte of snapshot
+    static unsigned char twi_snapshot_count;            // Valid bytes in snapshot
+    static volatile unsigned char twi_retries;          // Arbitration retries of running transaction
+    static volatile unsigned char twi_progress;         // Counts bus actions (timeout of waits)
+#endif
+
 //  +---------------------------------------------------------------+
 //  |                   TWI initialization                          |
 //  +---------------------------------------------------------------+
-//  | Parameter:    operation   ->  0x01 = Master mode              |
+//  | Parameter:    operation   ->  0x02 = Multi-master mode        |
+//  |                               0x01 = Master mode              |
 //  |                               0x00 = Slave mode               |
 //  |                                                               |
 //  |    Return:    BIT(7:3)    ->  TWS7 - TWS3                     |
@@ -36,14 +61,25 @@ unsigned char twi_init(TWI_Mode operation)
                     TWSR &= ~(0x03);                        // Reset TWI Prescaler
                     TWCR = (1<<TWEA) | (1<<TWEN);           // Enable TWI Bus and Acknowledge to TWI_ADDR or general call
                     break;
-        default :           // Master mode
+        default :           // Master/Multi-master mode
                     TWBR = (unsigned char)(TWI_BITRATE);    // Setup TWI Bitrate
                     TWSR = (unsigned char)(TWI_PRESCALE);   // Setup TWI Prescaler
+                    
+                    // Acknowledge to TWI_ADDR while not transmitting (interrupt mode only,
+                    // in polling mode a slave access would hold the bus)
+                    #ifdef TWI_TWIE
+                        if(operation == TWI_Multimaster)
+                            TWCR = (1<<TWEA) | (1<<TWEN);
+                    #endif
                     break;
     }
     
     // TWI interrupt setup
     #ifdef TWI_TWIE
+        // Answer own address in slave and multi-master mode
+        twi_listen = (operation != TWI_Master) ? (1<<TWEA) : 0;
+        twi_retries = 0;
+        
         TWCR  |= (1<<TWIE);
         sei();
     #endif
@@ -77,21 +113,381 @@ unsigned char twi_status(void)
     return (0xF8 & TWSR) | (0x04 & (TWCR>>1));
 }
 
+//  +---------------------------------------------------------------+
+//  |                   TWI clock setup                             |
+//  +---------------------------------------------------------------+
+//  | Parameter:    frequency   ->  SCL clock in Hz (max. 400 kHz)  |
+//  |                                                               |
+//  |    Return:    0           ->  Frequency too low (unchanged)   |
+//  |               0x??        ->  Selected SCL clock in Hz        |
+//  +---------------------------------------------------------------+
+//  | SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS)                        |
+//  |                                                               |
+//  | The fastest setting that does not exceed the frequency is     |
+//  | selected. TWBR is at least 10 in master mode (datasheet), so  |
+//  | the maximum clock is F_CPU / 36 (12 MHz -> 333 kHz).          |
+//  +---------------------------------------------------------------+
+unsigned long twi_set_clock(unsigned long frequency)
+{
+    if(frequency > 400000UL)
+        frequency = 400000UL;
+    
+    if(frequency == 0)
+        return 0;
+    
+    // Bus clock divider without fixed part
+    unsigned long divider = (F_CPU + frequency - 1) / frequency;
+    
+    divider = (divider > 16) ? (divider - 16) : 0;
+    
+    for(unsigned char prescaler=0; prescaler < 4; prescaler++)
+    {
+        unsigned long factor = 2UL<<(2 * prescaler);    // 2 * 4^TWPS
+        unsigned long bitrate = (divider + factor - 1) / factor;
+        
+        if(bitrate < 10)
+            bitrate = 10;
+        
+        if(bitrate <= 255)
+        {
+            TWBR = (unsigned char)(bitrate);
+            TWSR = prescaler;
+            
+            return F_CPU / (16 + (bitrate * factor));
+        }
+    }
+    return 0;
+}
+
+#ifndef TWI_TWIE
+
+    //  +---------------------------------------------------------------+
+    //  |                   TWI start + address slave                   |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    address     ->  Adress (Bit6:0) of slave device |
+    //  |               operation   ->  WRITE/READ operation            |
+    //  |                                                               |
+    //  |    Return:    TWI_None    ->  Slave acknowledged its address  |
+    //  |               TWI_Address ->  No slave with this address      |
+    //  |               TWI_???     ->  Bus error (see twi.h)           |
+    //  +---------------------------------------------------------------+
+    static TWI_Error twi_select(unsigned char address, TWI_Operation operation)
+    {
+        TWI_Error error = twi_start();
+        
+        if(error == TWI_None)
+            error = twi_address(address, operation);
+        
+        if((error == TWI_None) && ((twi_status() & 0xF8) != TWI_STATUS_ADDRESS_WRITE_ACK) && ((twi_status() & 0xF8) != TWI_STATUS_ADDRESS_READ_ACK))
+            error = TWI_Address;
+        
+        return error;
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   TWI end transaction                         |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    error       ->  Result of the transaction       |
+    //  |                                                               |
+    //  |    Return:    error                                           |
+    //  +---------------------------------------------------------------+
+    //  | STOP is only generated if the bus is owned (not after lost    |
+    //  | arbitration or bus error). After lost arbitration TWINT is    |
+    //  | cleared without STOP, so SCL is not held LOW during backoff.  |
+    //  +---------------------------------------------------------------+
+    static TWI_Error twi_finish(TWI_Error error)
+    {
+        if(error == TWI_Arbitration)
+            TWCR = (1<<TWINT) | (1<<TWEN);  // Release bus (not addressed slave)
+        else if(error != TWI_Bus)
+            twi_stop();
+        
+        return error;
+    }
+    
+    //  +---------------------------------------------------------------+
+    //  |                   TWI arbitration backoff                     |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    attempt     ->  Number of lost arbitrations - 1 |
+    //  |                                                               |
+    //  |    Return:    0x00        ->  No retry (TWI_RETRY reached)    |
+    //  |               0x01        ->  Retry transaction               |
+    //  +---------------------------------------------------------------+
+    //  | Delay = TWI_BACKOFF * 2^attempt + (TWI_ADDRESS & 0x0F) us     |
+    //  | Masters with different addresses retry at different times.   |
+    //  +---------------------------------------------------------------+
+    static unsigned char twi_backoff(unsigned char attempt)
+    {
+        if(attempt >= TWI_RETRY)
+            return 0x00;
+        
+        unsigned int delay = (TWI_BACKOFF<<attempt) + (0x0F & TWI_ADDRESS);
+        
+        while(delay--)
+            _delay_us(1);
+        
+        return 0x01;
+    }
+
+#else
+
+    //  +---------------------------------------------------------------+
+    //  |                   TWI run transaction and wait                |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    job (ptr)   ->  Transaction (on caller stack)   |
+    //  |                                                               |
+    //  |    Return:    TWI_???     ->  Result of the transaction       |
+    //  +---------------------------------------------------------------+
+    //  | Waits at most TWI_TIMEOUT us for the next bus action. A stuck |
+    //  | bus is freed with twi_recover(), which finishes the running   |
+    //  | transaction with TWI_Timeout. This is repeated until the job  |
+    //  | has left the queue, so the ISR never accesses it after the    |
+    //  | caller has returned.                                          |
+    //  +---------------------------------------------------------------+
+    static TWI_Error twi_job_run(TWI_Job *job)
+    {
+        unsigned char queued = 0;
+        unsigned char progress = twi_progress;
+        unsigned int timeout = TWI_TIMEOUT;
+        
+        // Queue job (wait if queue is full) and wait until it is complete
+        while(!queued || (job->status != TWI_Complete))
+        {
+            if(!queued && !twi_queue(job))
+                queued = 1;
+            else if(progress != twi_progress)
+            {
+                progress = twi_progress;    // Bus action done, restart timeout
+                timeout = TWI_TIMEOUT;
+            }
+            else if(!timeout--)
+            {
+                twi_recover();              // Aborts running transaction
+                timeout = TWI_TIMEOUT;
+            }
+            else
+                _delay_us(1);
+        }
+        return job->error;
+    }
+
+#endif
+
+//  +---------------------------------------------------------------+
+//  |                   TWI check slave address                     |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Adress (Bit6:0) of slave device |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Slave acknowledged its address  |
+//  |               TWI_Address ->  No slave with this address      |
+//  |               TWI_???     ->  Bus error (see twi.h)           |
+//  +---------------------------------------------------------------+
+TWI_Error twi_probe(unsigned char address)
+{
+    #ifndef TWI_TWIE
+        unsigned char attempt = 0;
+        TWI_Error error;
+        
+        do
+            error = twi_finish(twi_select(address, TWI_Write));
+        while((error == TWI_Arbitration) && twi_backoff(attempt++));
+        
+        return error;
+    #else
+        // Transaction without data only transmits the address
+        TWI_Job job = { address, NULL, 0, NULL, 0, NULL, TWI_Queued, TWI_None, NULL, 0 };
+        
+        return twi_job_run(&job);
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TWI bus scan                                |
+//  +---------------------------------------------------------------+
+//  | Parameter:    list (ptr)  ->  Buffer for found addresses      |
+//  |               size        ->  Size of the buffer              |
+//  |                                                               |
+//  |    Return:    0x??        ->  Number of found slaves          |
+//  +---------------------------------------------------------------+
+//  | Checks all addresses from 0x08 to 0x77 (0x00-0x07 and         |
+//  | 0x78-0x7F are reserved). Found slaves are counted if the      |
+//  | buffer is full.                                               |
+//  +---------------------------------------------------------------+
+unsigned char twi_scan(unsigned char *list, unsigned char size)
+{
+    unsigned char count = 0;
+    
+    for(unsigned char address=0x08; address < 0x78; address++)
+    {
+        if(twi_probe(address) == TWI_None)
+        {
+            if(count < size)
+                list[count] = address;
+            
+            count++;
+        }
+    }
+    return count;
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TWI write registers                         |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Adress (Bit6:0) of slave device |
+//  |               reg         ->  First register                  |
+//  |               data (ptr)  ->  Register data                   |
+//  |               length      ->  Number of registers             |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Registers written               |
+//  |               TWI_Address ->  Slave did not answer            |
+//  |               TWI_Data    ->  Slave rejected data             |
+//  |               TWI_???     ->  Bus error (see twi.h)           |
+//  +---------------------------------------------------------------+
+//  | Sequence:     START, SLA+W, reg, data[0..length-1], STOP      |
+//  +---------------------------------------------------------------+
+TWI_Error twi_write_regs(unsigned char address, unsigned char reg, const unsigned char *data, unsigned int length)
+{
+    #ifndef TWI_TWIE
+        unsigned char attempt = 0;
+        TWI_Error error;
+        
+        do
+        {
+            error = twi_select(address, TWI_Write);
+            
+            for(unsigned int i=0; (i <= length) && (error == TWI_None); i++)
+            {
+                error = twi_set(i ? data[i - 1] : reg);
+                
+                // Slave may reject the last byte
+                if((error == TWI_None) && (i < length) && ((twi_status() & 0xF8) != TWI_STATUS_DATA_WRITE_ACK))
+                    error = TWI_Data;
+            }
+            error = twi_finish(error);
+        }
+        while((error == TWI_Arbitration) && twi_backoff(attempt++));
+        
+        return error;
+    #else
+        // Register from tx, data directly from caller buffer (tx_data)
+        TWI_Job job = { address, &reg, 1, NULL, 0, NULL, TWI_Queued, TWI_None, data, length };
+        
+        return twi_job_run(&job);
+    #endif
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TWI write register                          |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Adress (Bit6:0) of slave device |
+//  |               reg         ->  Register                        |
+//  |               data        ->  Register data                   |
+//  |                                                               |
+//  |    Return:    TWI_???     ->  See twi_write_regs()            |
+//  +---------------------------------------------------------------+
+TWI_Error twi_write_reg(unsigned char address, unsigned char reg, unsigned char data)
+{
+    return twi_write_regs(address, reg, &data, 1);
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TWI read registers                          |
+//  +---------------------------------------------------------------+
+//  | Parameter:    address     ->  Adress (Bit6:0) of slave device |
+//  |               reg         ->  First register                  |
+//  |               data (ptr)  ->  Receive buffer                  |
+//  |               length      ->  Number of registers             |
+//  |                                                               |
+//  |    Return:    TWI_None    ->  Registers read                  |
+//  |               TWI_Address ->  Slave did not answer            |
+//  |               TWI_Data    ->  Slave rejected register         |
+//  |               TWI_???     ->  Bus error (see twi.h)           |
+//  +---------------------------------------------------------------+
+//  | Sequence:     START, SLA+W, reg, REPEATED START, SLA+R,       |
+//  |               data[0..length-1] (ACK, last byte NACK), STOP   |
+//  +---------------------------------------------------------------+
+TWI_Error twi_read_regs(unsigned char address, unsigned char reg, unsigned char *data, unsigned int length)
+{
+    #ifndef TWI_TWIE
+        unsigned char attempt = 0;
+        TWI_Error error;
+        
+        do
+        {
+            error = twi_select(address, TWI_Write);
+            
+            if(error == TWI_None)
+                error = twi_set(reg);
+            
+            if((error == TWI_None) && ((twi_status() & 0xF8) != TWI_STATUS_DATA_WRITE_ACK))
+                error = TWI_Data;
+            
+            if((error == TWI_None) && length)
+                error = twi_select(address, TWI_Read);
+            
+            for(unsigned int i=0; (i < length) && (error == TWI_None); i++)
+                error = twi_get(&data[i], (i < (length - 1)) ? TWI_ACK : TWI_NACK);
+            
+            error = twi_finish(error);
+        }
+        while((error == TWI_Arbitration) && twi_backoff(attempt++));
+        
+        return error;
+    #else
+        TWI_Job job = { address, &reg, 1, data, length, NULL, TWI_Queued, TWI_None, NULL, 0 };
+        
+        return twi_job_run(&job);
+    #endif
+}
+
 #ifndef TWI_TWIE
 
+    //  +---------------------------------------------------------------+
+    //  |                   TWI wait for bus action                     |
+    //  +---------------------------------------------------------------+
+    //  |    Return:    TWI_None        ->  Bus action done             |
+    //  |               TWI_Timeout     ->  Not done within TWI_TIMEOUT |
+    //  |               TWI_Bus         ->  Bus error (bus released)    |
+    //  +---------------------------------------------------------------+
+    static TWI_Error twi_wait(void)
+    {
+        unsigned int timeout = TWI_TIMEOUT;
+        
+        // Check if bus action done
+        while(!(TWCR & (1<<TWINT)))
+        {
+            if(!timeout--)
+                return TWI_Timeout;
+            
+            _delay_us(1);
+        }
+        
+        // Illegal START/STOP, release bus without STOP condition
+        if((TWSR & 0xF8) == TWI_STATUS_BUS_ERROR)
+        {
+            TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO);
+            return TWI_Bus;
+        }
+        return TWI_None;
+    }
+
     //  +---------------------------------------------------------------+
     //  |                   TWI start transmission                      |
     //  +---------------------------------------------------------------+
     //  |    Return:    TWI_None        ->  Start successful            |
     //  |               TWI_Start       ->  Start failure               |
+    //  |               TWI_Timeout     ->  Bus busy (see twi_recover())|
+    //  |               TWI_Bus         ->  Bus error                   |
     //  +---------------------------------------------------------------+
     TWI_Error twi_start(void)
     {
         TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN); // Start a TWI transmission
                             
         // Check if START done
-        while(!(TWCR & (1<<TWINT)))
-            asm volatile("NOP");
+        TWI_Error error = twi_wait();
+        
+        if(error != TWI_None)
+            return error;
     
         // Check if an error occurred
         if(((TWSR & 0xF8) == TWI_STATUS_START) || ((TWSR & 0xF8) == TWI_STATUS_REPEATED_START))
@@ -102,12 +498,24 @@ unsigned char twi_status(void)
     //  +---------------------------------------------------------------+
     //  |                   TWI stop transmission                       |
     //  +---------------------------------------------------------------+
-    void twi_stop(void)
+    //  |    Return:    TWI_None        ->  Stop successful             |
+    //  |               TWI_Timeout     ->  Stop not executed           |
+    //  +---------------------------------------------------------------+
+    TWI_Error twi_stop(void)
     {
+        unsigned int timeout = TWI_TIMEOUT;
+        
         TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO); // Stop a TWI transmission
-    
-        while(!(TWCR & (1<<TWSTO)))
-            asm volatile("NOP");
+        
+        // TWSTO is cleared when STOP is executed
+        while(TWCR & (1<<TWSTO))
+        {
+            if(!timeout--)
+                return TWI_Timeout;
+            
+            _delay_us(1);
+        }
+        return TWI_None;
     }
 
     //  +---------------------------------------------------------------+
@@ -118,6 +526,8 @@ unsigned char twi_status(void)
     //  |                                                               |
     //  |    Return:    TWI_None        ->  Addressing successful       |
     //  |               TWI_Arbitration ->  Arbitration lost (m. master)|
+    //  |               TWI_Timeout     ->  No response (clock stretch) |
+    //  |               TWI_Bus         ->  Bus error                   |
     //  |               TWI_General     ->  Error occured               |
     //  +---------------------------------------------------------------+
     TWI_Error twi_address(unsigned char address, TWI_Operation operation)
@@ -126,8 +536,10 @@ unsigned char twi_status(void)
         TWCR = (1<<TWINT) | (1<<TWEN);              // Transmit address byte + operation
     
         // Check if transmission done
-        while(!(TWCR & (1<<TWINT)))
-            asm volatile("NOP");
+        TWI_Error error = twi_wait();
+        
+        if(error != TWI_None)
+            return error;
     
         // ADDRESS + WRITE operation
         if(operation == TWI_Write)
@@ -156,6 +568,8 @@ unsigned char twi_status(void)
     //  |                                                               |
     //  |    Return:    TWI_None        ->  Data transmitted successful |
     //  |               TWI_Arbitration ->  Arbitration lost (m. master)|
+    //  |               TWI_Timeout     ->  No response (clock stretch) |
+    //  |               TWI_Bus         ->  Bus error                   |
     //  |               TWI_General     ->  Error occured               |
     //  +---------------------------------------------------------------+
     TWI_Error twi_set(unsigned char data)
@@ -164,8 +578,10 @@ unsigned char twi_status(void)
         TWCR = (1<<TWINT) | (1<<TWEN);              // Transmit databyte
     
         // Check if transmission done
-        while(!(TWCR & (1<<TWINT)))
-            asm volatile("NOP");
+        TWI_Error error = twi_wait();
+        
+        if(error != TWI_None)
+            return error;
     
         // Check if an error occurred
         if(((TWSR & 0xF8) == TWI_STATUS_DATA_WRITE_ACK) || ((TWSR & 0xF8) == TWI_STATUS_DATA_WRITE_NACK))
@@ -187,6 +603,8 @@ unsigned char twi_status(void)
     //  |    Return:    TWI_None        ->  Data received successful    |
     //  |               TWI_Acknowledge ->  Wrong ACK/NACK parameter    |
     //  |               TWI_Arbitration ->  Arbitration lost (m. master)|
+    //  |               TWI_Timeout     ->  No response (clock stretch) |
+    //  |               TWI_Bus         ->  Bus error                   |
     //  |               TWI_General     ->  Error occured               |
     //  +---------------------------------------------------------------+
     TWI_Error twi_get(unsigned char *data, TWI_Acknowledge acknowledge)
@@ -201,8 +619,10 @@ unsigned char twi_status(void)
             return TWI_Ack;
     
         // Check if transmission done
-        while (!(TWCR & (1<<TWINT)))
-            asm volatile("NOP");
+        TWI_Error error = twi_wait();
+        
+        if(error != TWI_None)
+            return error;
     
         // TWI_Write Data to pointer
         *data = TWDR;
@@ -218,4 +638,509 @@ unsigned char twi_status(void)
         return TWI_General;
     }
 
-#endif
\ No newline at end of file
+#endif
+
+#ifdef TWI_TWIE
+
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+    // !!! TWCR must not be changed with read- !!!
+    // !!! modify-write while TWINT is set,    !!!
+    // !!! a written 1 clears TWINT and starts !!!
+    // !!! the next bus action. The queue is   !!!
+    // !!! locked by disabling interrupts.     !!!
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+    //  +---------------------------------------------------------------+
+    //  |               TWI complete running transaction                |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    error   ->  Result of the transaction           |
+    //  +---------------------------------------------------------------+
+    //  | Called from ISR. Removes the transaction from the queue and   |
+    //  | calls the callback, the bus is not changed.                   |
+    //  +---------------------------------------------------------------+
+    static void twi_job_complete(TWI_Error error)
+    {
+        TWI_Job *job = twi_jobs[twi_tail];
+        
+        if(++twi_tail >= TWI_QUEUE_SIZE)
+            twi_tail = 0;
+        
+        twi_count--;
+        twi_retries = 0;
+        
+        job->error = error;
+        job->status = TWI_Complete;
+        
+        // Callback can queue a new transaction (bus is still active)
+        if(job->callback != NULL)
+            job->callback(job);
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               TWI finish running transaction                  |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    error   ->  Result of the transaction           |
+    //  +---------------------------------------------------------------+
+    //  | Called from ISR. Releases the bus (STOP) or starts the next   |
+    //  | queued transaction (STOP + START).                            |
+    //  +---------------------------------------------------------------+
+    static void twi_job_finish(TWI_Error error)
+    {
+        twi_job_complete(error);
+        
+        unsigned char control = (1<<TWINT) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+        
+        // Bus is lost after arbitration, STOP is not allowed
+        if(error != TWI_Arbitration)
+            control |= (1<<TWSTO);
+        
+        // START of next transaction as soon as the bus is free
+        if(twi_count)
+            control |= (1<<TWSTA);
+        else
+            twi_active = 0;
+        
+        TWCR = control;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               TWI queue transaction                           |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    job (ptr)   ->  Transaction (has to be valid    |
+    //  |                               until it is complete)           |
+    //  |                                                               |
+    //  |    Return:    0x00    ->  Transaction queued                  |
+    //  |               0xFF    ->  Queue full                          |
+    //  +---------------------------------------------------------------+
+    //  | Sequence:     START, SLA+W, tx[0..tx_length-1],               |
+    //  |               tx_data[0..tx_data_length-1],                   |
+    //  |               (REPEATED) START, SLA+R, rx[0..rx_length-1],    |
+    //  |               STOP                                            |
+    //  |                                                               |
+    //  | The write phase is skipped if only data is read and the read  |
+    //  | phase if rx_length is 0. Without any data only the slave      |
+    //  | address is transmitted (device check).                        |
+    //  +---------------------------------------------------------------+
+    unsigned char twi_queue(TWI_Job *job)
+    {
+        unsigned char status = 0xFF;
+        
+        unsigned char sreg = SREG;
+        cli();  // Lock TWI interrupt
+        
+        if(twi_count < TWI_QUEUE_SIZE)
+        {
+            job->status = TWI_Queued;
+            job->error = TWI_None;
+            
+            twi_jobs[twi_head] = job;
+            
+            if(++twi_head >= TWI_QUEUE_SIZE)
+                twi_head = 0;
+            
+            twi_count++;
+            
+            // Start transaction if bus is idle (a running slave
+            // transfer starts the queue when it is finished)
+            if(!twi_active && !twi_slave_busy)
+            {
+                twi_active = 1;
+                TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+            }
+            
+            status = 0x00;
+        }
+        
+        SREG = sreg;    // Unlock TWI interrupt
+        
+        return status;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               TWI transactions pending                        |
+    //  +---------------------------------------------------------------+
+    //  |    Return:    0x00    ->  Queue empty                         |
+    //  |               0x??    ->  Number of pending transactions      |
+    //  +---------------------------------------------------------------+
+    unsigned char twi_busy(void)
+    {
+        return twi_count;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               TWI slave register map                          |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    registers   ->  Register memory                 |
+    //  |               size        ->  Number of registers             |
+    //  |               first       ->  First writable register         |
+    //  |               last        ->  Last writable register          |
+    //  |                               (last < first = read only)      |
+    //  |               callback    ->  Called from ISR after a master  |
+    //  |                               wrote a register (NULL = none)  |
+    //  +---------------------------------------------------------------+
+    //  | Master write: [pointer] [data] [data] ...                     |
+    //  | Master read:  [data] [data] ... (from pointer)                |
+    //  |                                                               |
+    //  | The pointer is incremented after every byte and wraps at the  |
+    //  | end of the map. Writes to read only registers are ignored.    |
+    //  |                                                               |
+    //  | When addressed for read, TWI_SNAPSHOT registers from the      |
+    //  | pointer on are copied and sent from the copy, so a value with |
+    //  | more than one byte cannot change in the middle of the read.   |
+    //  | Multi-byte values have to be written with interrupts disabled |
+    //  | (the copy must not be taken between two bytes).               |
+    //  +---------------------------------------------------------------+
+    void twi_slave_map(volatile unsigned char *registers, unsigned char size, unsigned char first, unsigned char last, void (*callback)(unsigned char address))
+    {
+        unsigned char sreg = SREG;
+        cli();
+        
+        twi_map = registers;
+        twi_map_size = size;
+        twi_map_first = first;
+        twi_map_last = last;
+        twi_map_callback = callback;
+        twi_pointer = 0;
+        twi_snapshot_count = 0;
+        
+        SREG = sreg;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               TWI slave state machine                         |
+    //  +---------------------------------------------------------------+
+    //  | Parameter:    status  ->  TWI status (TWSR & 0xF8)            |
+    //  +---------------------------------------------------------------+
+    //  | Called from ISR                                               |
+    //  +---------------------------------------------------------------+
+    static void twi_slave(unsigned char status)
+    {
+        unsigned char control = (1<<TWINT) | (1<<TWEA) | (1<<TWEN) | (1<<TWIE);
+        
+        // Addressed while own transaction lost arbitration, the
+        // transaction is repeated after the slave transfer
+        if(twi_active && ((status == TWI_STATUS_SLAVE_WRITE_ARBITRATION) || (status == TWI_STATUS_SLAVE_GENERAL_ARBITRATION) || (status == TWI_STATUS_SLAVE_READ_ARBITRATION)))
+        {
+            if(twi_retries < TWI_RETRY)
+            {
+                twi_retries++;
+                twi_jobs[twi_tail]->status = TWI_Queued;
+            }
+            else
+                twi_job_complete(TWI_Arbitration);
+            
+            twi_active = 0;
+        }
+        
+        switch(status)
+        {
+            // Addressed for write, first byte is the register pointer
+            case TWI_STATUS_SLAVE_WRITE_ACK :
+            case TWI_STATUS_SLAVE_WRITE_ARBITRATION :
+            case TWI_STATUS_SLAVE_GENERAL_ACK :
+            case TWI_STATUS_SLAVE_GENERAL_ARBITRATION :
+                        twi_slave_busy = 1;
+                        twi_pointer_set = 0;
+                        break;
+            // Register pointer or data received
+            case TWI_STATUS_SLAVE_DATA_ACK :
+            case TWI_STATUS_SLAVE_DATA_NACK :
+            case TWI_STATUS_SLAVE_GENERAL_DATA_ACK :
+            case TWI_STATUS_SLAVE_GENERAL_DATA_NACK :
+                        if(!twi_pointer_set)
+                        {
+                            twi_pointer = TWDR;
+                            twi_pointer_set = 1;
+                            
+                            if(twi_pointer >= twi_map_size)
+                                twi_pointer = 0;
+                        }
+                        else if(twi_map_size)
+                        {
+                            unsigned char address = twi_pointer;
+                            
+                            if((address >= twi_map_first) && (address <= twi_map_last))
+                            {
+                                twi_map[address] = TWDR;
+                                
+                                if(twi_map_callback != NULL)
+                                    twi_map_callback(address);
+                            }
+                            
+                            if(++twi_pointer >= twi_map_size)
+                                twi_pointer = 0;
+                        }
+                        break;
+            // Addressed for read, copy registers from pointer on
+            case TWI_STATUS_SLAVE_READ_ACK :
+            case TWI_STATUS_SLAVE_READ_ARBITRATION :
+                        {
+                            unsigned char address = twi_pointer;
+                            
+                            for(twi_snapshot_count=0; (twi_snapshot_count < TWI_SNAPSHOT) && (twi_snapshot_count < twi_map_size); twi_snapshot_count++)
+                            {
+                                twi_snapshot[twi_snapshot_count] = twi_map[address];
+                                
+                                if(++address >= twi_map_size)
+                                    address = 0;
+                            }
+                            twi_snapshot_index = 0;
+                        }
+                        // Fall through (send first byte)
+            // Master acknowledged data
+            case TWI_STATUS_SLAVE_TRANSMIT_ACK :
+                        twi_slave_busy = 1;
+                        
+                        if(twi_map_size)
+                        {
+                            // Registers after the snapshot are read directly
+                            if(twi_snapshot_index < twi_snapshot_count)
+                                TWDR = twi_snapshot[twi_snapshot_index++];
+                            else
+                                TWDR = twi_map[twi_pointer];
+                            
+                            if(++twi_pointer >= twi_map_size)
+                                twi_pointer = 0;
+                        }
+                        else
+                            TWDR = 0xFF;
+                        break;
+            // End of slave transfer (STOP/REPEATED START or master NACK)
+            default :
+                        twi_slave_busy = 0;
+                        
+                        // Start queued transactions as soon as the bus is free
+                        if(twi_count)
+                        {
+                            twi_active = 1;
+                            control |= (1<<TWSTA);
+                        }
+                        break;
+        }
+        
+        TWCR = control;
+    }
+
+    //  +---------------------------------------------------------------+
+    //  |               TWI interrupt                                   |
+    //  +---------------------------------------------------------------+
+    ISR(TWI_vect)
+    {
+        unsigned char status = TWSR & 0xF8;
+        
+        twi_progress++;
+        
+        // Slave receiver/transmitter
+        if((status >= TWI_STATUS_SLAVE_WRITE_ACK) && (status <= TWI_STATUS_SLAVE_TRANSMIT_LAST))
+        {
+            twi_slave(status);
+            return;
+        }
+        
+        // No transaction running (bus error releases the bus)
+        if(!twi_active)
+        {
+            if(status == TWI_STATUS_BUS_ERROR)
+                TWCR = (1<<TWINT) | (1<<TWSTO) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+            else
+                TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+            return;
+        }
+        
+        TWI_Job *job = twi_jobs[twi_tail];
+        
+        // Master transmitter/receiver
+        switch(status)
+        {
+            // START: write phase, or read phase if nothing to write
+            case TWI_STATUS_START :
+                        job->status = TWI_Running;
+                        twi_index = 0;
+                        
+                        if((job->tx_length == 0) && (job->tx_data_length == 0) && (job->rx_length != 0))
+                            TWDR = (job->address<<1) | TWI_READ;
+                        else
+                            TWDR = (job->address<<1) | TWI_WRITE;
+                        
+                        TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+                        break;
+            // REPEATED START: read phase
+            case TWI_STATUS_REPEATED_START :
+                        twi_index = 0;
+                        
+                        TWDR = (job->address<<1) | TWI_READ;
+                        TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+                        break;
+            // Slave accepted address or data byte
+            case TWI_STATUS_ADDRESS_WRITE_ACK :
+            case TWI_STATUS_DATA_WRITE_ACK :
+                        if(twi_index < job->tx_length)
+                        {
+                            TWDR = job->tx[twi_index++];
+                            TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+                        }
+                        else if(twi_index < (job->tx_length + job->tx_data_length))
+                        {
+                            TWDR = job->tx_data[twi_index++ - job->tx_length];
+                            TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+                        }
+                        else if(job->rx_length)
+                            TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+                        else
+                            twi_job_finish(TWI_None);
+                        break;
+            // Slave rejected data byte (allowed for the last byte)
+            case TWI_STATUS_DATA_WRITE_NACK :
+                        if(twi_index < (job->tx_length + job->tx_data_length))
+                            twi_job_finish(TWI_Data);
+                        else if(job->rx_length)
+                            TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+                        else
+                            twi_job_finish(TWI_None);
+                        break;
+            // Slave accepted read address, NACK if only one byte is read
+            case TWI_STATUS_ADDRESS_READ_ACK :
+                        if(job->rx_length > 1)
+                            TWCR = (1<<TWINT) | (1<<TWEA) | (1<<TWEN) | (1<<TWIE);
+                        else
+                            TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWIE);
+                        break;
+            // Byte received, NACK the last byte
+            case TWI_STATUS_DATA_READ_ACK :
+                        job->rx[twi_index++] = TWDR;
+                        
+                        if(twi_index < (job->rx_length - 1))
+                            TWCR = (1<<TWINT) | (1<<TWEA) | (1<<TWEN) | (1<<TWIE);
+                        else
+                            TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWIE);
+                        break;
+            // Last byte received
+            case TWI_STATUS_DATA_READ_NACK :
+                        job->rx[twi_index] = TWDR;
+                        twi_job_finish(TWI_None);
+                        break;
+            // Slave not present or busy
+            case TWI_STATUS_ADDRESS_WRITE_NACK :
+            case TWI_STATUS_ADDRESS_READ_NACK :
+                        twi_job_finish(TWI_Address);
+                        break;
+            // Another master took the bus, START is repeated
+            // as soon as the bus is free again (after STOP)
+            case TWI_STATUS_ARBITRATION_LOST :
+                        if(twi_retries < TWI_RETRY)
+                        {
+                            twi_retries++;
+                            job->status = TWI_Queued;
+                            TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+                        }
+                        else
+                            twi_job_finish(TWI_Arbitration);
+                        break;
+            // Illegal START/STOP (STOP flag releases the bus)
+            case TWI_STATUS_BUS_ERROR :
+                        twi_job_finish(TWI_Bus);
+                        break;
+            default :
+                        twi_job_finish(TWI_General);
+                        break;
+        }
+    }
+
+#endif
+
+//  +---------------------------------------------------------------+
+//  |                   TWI bus line LOW/released                   |
+//  +---------------------------------------------------------------+
+//  | Parameter:    line    ->  TWI_SCL/TWI_SDA                     |
+//  |               mode    ->  0x00 = LOW (output)                 |
+//  |                           0x?? = Released (input + pullup)    |
+//  +---------------------------------------------------------------+
+static void twi_line(unsigned char line, unsigned char mode)
+{
+    if(!mode)
+    {
+        TWI_PORT &= ~(1<<line);
+        TWI_DDR |= (1<<line);
+    }
+    else
+    {
+        TWI_DDR &= ~(1<<line);
+        TWI_PORT |= (mode & (1<<line));
+    }
+    _delay_us(5);   // Half period at 100 kHz
+}
+
+//  +---------------------------------------------------------------+
+//  |                   TWI bus recovery                            |
+//  +---------------------------------------------------------------+
+//  |    Return:    TWI_None    ->  Bus free                        |
+//  |               TWI_Bus     ->  SDA/SCL still held LOW          |
+//  +---------------------------------------------------------------+
+//  | A slave that was interrupted during a read (e.g. reset of     |
+//  | the controller) holds SDA LOW until it has shifted out its    |
+//  | byte. SCL is clocked up to 9 times until SDA is released and  |
+//  | a STOP condition is generated. In interrupt mode the running  |
+//  | transaction is finished with TWI_Timeout.                     |
+//  +---------------------------------------------------------------+
+TWI_Error twi_recover(void)
+{
+    unsigned char sreg = SREG;
+    cli();
+    
+    unsigned char control = TWCR & ((1<<TWEA) | (1<<TWIE));
+    unsigned char release = 0xFF & ~((1<<TWI_SCL) | (1<<TWI_SDA));  // Released without pullup
+    
+    release |= TWI_PORT & ((1<<TWI_SCL) | (1<<TWI_SDA));            // Keep pullup setup
+    
+    #ifdef TWI_TWIE
+        // Abort running transaction
+        if(twi_active)
+        {
+            twi_job_complete(TWI_Timeout);
+            twi_active = 0;
+        }
+        twi_slave_busy = 0;
+    #endif
+    
+    TWCR = 0x00;    // Disable TWI, SCL/SDA are port pins
+    
+    twi_line(TWI_SCL, release);
+    twi_line(TWI_SDA, release);
+    
+    // Clock SCL until slave releases SDA
+    for(unsigned char i=0; (i < 9) && !(TWI_PIN & (1<<TWI_SDA)); i++)
+    {
+        twi_line(TWI_SCL, 0x00);
+        twi_line(TWI_SCL, release);
+        
+        // Slave may stretch the clock
+        for(unsigned char j=0; (j < 100) && !(TWI_PIN & (1<<TWI_SCL)); j++)
+            _delay_us(1);
+    }
+    
+    // STOP condition (SDA LOW -> HIGH while SCL HIGH)
+    twi_line(TWI_SCL, 0x00);
+    twi_line(TWI_SDA, 0x00);
+    twi_line(TWI_SCL, release);
+    twi_line(TWI_SDA, release);
+    
+    TWI_Error error = TWI_None;
+    
+    if((TWI_PIN & ((1<<TWI_SCL) | (1<<TWI_SDA))) != ((1<<TWI_SCL) | (1<<TWI_SDA)))
+        error = TWI_Bus;
+    
+    TWCR = (1<<TWEN) | control;         // Enable TWI
+    
+    #ifdef TWI_TWIE
+        // Continue with queued transactions
+        if(twi_count)
+        {
+            twi_active = 1;
+            TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN) | (1<<TWIE) | twi_listen;
+        }
+    #endif
+    
+    SREG = sreg;
+    
+    return error;
+}
\ No newline at end of file
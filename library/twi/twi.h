@@ -58,38 +58,102 @@
     #define TWI_READ 0x01
 #endif
 
+#ifndef TWI_QUEUE_SIZE      // Number of queued transactions (interrupt mode)
+    #define TWI_QUEUE_SIZE 4
+#endif
+
+#ifndef TWI_SNAPSHOT        // Registers copied at the start of a slave read (interrupt mode)
+    #define TWI_SNAPSHOT 8  // (read as one consistent block)
+#endif
+
+#if (TWI_SNAPSHOT < 1) || (TWI_SNAPSHOT > 255)
+    #error "TWI_SNAPSHOT must be 1 - 255"
+#endif
+
+#ifndef TWI_TIMEOUT         // Maximum wait for a bus action in us (approximate)
+    #define TWI_TIMEOUT 1000
+#endif
+
+#ifndef TWI_RETRY           // Retries of a transaction after lost arbitration (multi-master)
+    #define TWI_RETRY 4
+#endif
+
+#ifndef TWI_BACKOFF         // First retry delay in us, doubled every retry (polling mode)
+    #define TWI_BACKOFF 50
+#endif
+
+#ifndef TWI_DDR             // Port direction register
+    #define TWI_DDR DDRC
+#endif
+
+#ifndef TWI_PIN             // Pin for TWI setup
+    #define TWI_PIN PINC
+#endif
+
+#ifndef TWI_PORT            // Port for TWI setup
+    #define TWI_PORT PORTC
+#endif
+
+#ifndef TWI_SCL             // Clock
+    #define TWI_SCL PC0
+#endif
+
+#ifndef TWI_SDA             // Data
+    #define TWI_SDA PC1
+#endif
+
 // ATmega status codes (!!! Do not change !!!)
+#define TWI_STATUS_BUS_ERROR            0x00
 #define TWI_STATUS_START                0x08
 #define TWI_STATUS_REPEATED_START       0x10
-#define TWI_STATUS_ADDRESS_WRITE_NACK   0x18
-#define TWI_STATUS_ADDRESS_WRITE_ACK    0x20
-#define TWI_STATUS_DATA_WRITE_NACK      0x28
-#define TWI_STATUS_DATA_WRITE_ACK       0x30
+#define TWI_STATUS_ADDRESS_WRITE_ACK    0x18
+#define TWI_STATUS_ADDRESS_WRITE_NACK   0x20
+#define TWI_STATUS_DATA_WRITE_ACK       0x28
+#define TWI_STATUS_DATA_WRITE_NACK      0x30
 #define TWI_STATUS_ARBITRATION_LOST     0x38
 #define TWI_STATUS_ADDRESS_READ_ACK     0x40
 #define TWI_STATUS_ADDRESS_READ_NACK    0x48
 #define TWI_STATUS_DATA_READ_ACK        0x50
 #define TWI_STATUS_DATA_READ_NACK       0x58
 
+#define TWI_STATUS_SLAVE_WRITE_ACK              0x60    // Own SLA+W received
+#define TWI_STATUS_SLAVE_WRITE_ARBITRATION      0x68    // Own SLA+W received after arbitration lost
+#define TWI_STATUS_SLAVE_GENERAL_ACK            0x70    // General call received
+#define TWI_STATUS_SLAVE_GENERAL_ARBITRATION    0x78    // General call received after arbitration lost
+#define TWI_STATUS_SLAVE_DATA_ACK               0x80    // Data received, ACK returned
+#define TWI_STATUS_SLAVE_DATA_NACK              0x88    // Data received, NACK returned
+#define TWI_STATUS_SLAVE_GENERAL_DATA_ACK       0x90    // General call data received, ACK returned
+#define TWI_STATUS_SLAVE_GENERAL_DATA_NACK      0x98    // General call data received, NACK returned
+#define TWI_STATUS_SLAVE_STOP                   0xA0    // STOP or REPEATED START received
+#define TWI_STATUS_SLAVE_READ_ACK               0xA8    // Own SLA+R received
+#define TWI_STATUS_SLAVE_READ_ARBITRATION       0xB0    // Own SLA+R received after arbitration lost
+#define TWI_STATUS_SLAVE_TRANSMIT_ACK           0xB8    // Data transmitted, ACK received
+#define TWI_STATUS_SLAVE_TRANSMIT_NACK          0xC0    // Data transmitted, NACK received
+#define TWI_STATUS_SLAVE_TRANSMIT_LAST          0xC8    // Last data transmitted, ACK received
+
 // Definition of TWI processing (Enabled = Interrupt/Disabled = Polling)
 
 //  !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-//  !!! Interrupts are not included in this library  !!!
 //  !!! If interrupts are used, polling will be      !!!
-//  !!! disabled                                     !!!
+//  !!! disabled. Master transactions are queued     !!!
+//  !!! with twi_queue() and processed in the TWI    !!!
+//  !!! interrupt                                    !!!
 //  !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 //#ifndef TWI_TWIE  // TWI Interrupt based processing
 //  #define TWI_TWIE
 //#endif
 
+#include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <util/delay.h>
 
 enum TWI_Mode_t
 {
   TWI_Slave=0,
-  TWI_Master=1  
+  TWI_Master=1,
+  TWI_Multimaster=2
 };
 typedef enum TWI_Mode_t TWI_Mode;
 
@@ -113,20 +177,58 @@ enum TWI_Error_t
     TWI_Start,
     TWI_Arbitration,
     TWI_Ack,
-    TWI_General
+    TWI_General,
+    TWI_Address,    // Slave did not acknowledge address
+    TWI_Data,       // Slave did not acknowledge data
+    TWI_Timeout,    // Bus action not finished in time
+    TWI_Bus         // Bus error (illegal START/STOP or stuck SDA)
 };
 typedef enum TWI_Error_t TWI_Error;
 
+enum TWI_Job_Status_t
+{
+    TWI_Queued=0,
+    TWI_Running,
+    TWI_Complete
+};
+typedef enum TWI_Job_Status_t TWI_Job_Status;
+
+struct TWI_Job_t
+{
+    unsigned char address;                  // Slave address (Bit6:0)
+    const unsigned char *tx;                // Transmit data (written first)
+    unsigned int tx_length;                 // Number of bytes to write
+    unsigned char *rx;                      // Receive buffer (read after repeated start)
+    unsigned int rx_length;                 // Number of bytes to read
+    void (*callback)(struct TWI_Job_t *job);// Called from ISR on completion (NULL = none)
+    volatile TWI_Job_Status status;         // Transaction status
+    volatile TWI_Error error;               // Result if complete (TWI_None = success)
+    const unsigned char *tx_data;           // Transmit data written after tx (optional)
+    unsigned int tx_data_length;            // Number of bytes to write from tx_data
+};
+typedef struct TWI_Job_t TWI_Job;
+
 unsigned char twi_init(TWI_Mode operation);
          void twi_disable(void);
 unsigned char twi_status(void);
+    TWI_Error twi_recover(void);
+unsigned long twi_set_clock(unsigned long frequency);
+    TWI_Error twi_probe(unsigned char address);
+unsigned char twi_scan(unsigned char *list, unsigned char size);
+    TWI_Error twi_write_reg(unsigned char address, unsigned char reg, unsigned char data);
+    TWI_Error twi_write_regs(unsigned char address, unsigned char reg, const unsigned char *data, unsigned int length);
+    TWI_Error twi_read_regs(unsigned char address, unsigned char reg, unsigned char *data, unsigned int length);
 
 #ifndef TWI_TWIE
     TWI_Error twi_start(void);
-         void twi_stop(void);
+    TWI_Error twi_stop(void);
     TWI_Error twi_address(unsigned char address, TWI_Operation operation);
     TWI_Error twi_set(unsigned char data);
     TWI_Error twi_get(unsigned char *data, TWI_Acknowledge acknowledge);
+#else
+unsigned char twi_queue(TWI_Job *job);
+unsigned char twi_busy(void);
+         void twi_slave_map(volatile unsigned char *registers, unsigned char size, unsigned char first, unsigned char last, void (*callback)(unsigned char address));
 #endif
 
 
@@ -9,6 +9,7 @@
  * Description:
  *   Read data from A/D channel 5 and send
  *   data calculated to mV over UART
+ *   (event driven with task scheduler)
  * -----------------------------------------
  */ 
 
@@ -59,11 +60,61 @@
 
 // System libraries
 #include <avr/io.h>         // Required for I/O
-#include <util/delay.h>     // Required for _delay_ms()
 
 // User libraries
 #include "../../library/adc/adc.h"
 #include "../../library/uart/uart.h"
+#include "../../library/tick/tick.h"
+#include "../../library/task/task.h"
+
+// Task numbers (= priority, 0 = highest)
+#define TASK_MEASURE 0
+#define TASK_OUTPUT  1
+
+// Events
+#define EVENT_SAMPLE TASK_EVENT0
+#define EVENT_SEND   TASK_EVENT0
+
+// Measured voltage (handed from measure to output task)
+unsigned int mv;
+
+// Software timer callback (called from tick ISR every 100 ms)
+void sample_timer(unsigned char timer)
+{
+    task_post(TASK_MEASURE, EVENT_SAMPLE);
+}
+
+// Measure task: Reads A/D channel 5 and calculates the voltage
+void measure_task(unsigned char events)
+{
+    // Read data from A/D channel 5 and
+    // adjust it right
+    unsigned int data = (adc_read()>>6);
+    
+    // Write converted value to PORT
+    // PORT only has 8 Bit, so 2 bits
+    // have to be thrown away!
+    PORTC = (unsigned char)(data>>2);
+    
+    // Calculation the Voltage in mV on ADC channel(5)
+    //
+    //                5000 mV
+    // U_mV = data * --------- 
+    //                 2^10
+    //
+    // Better (faster) option for dividing /1024 is shifting 10 bits right (2^10)
+    // unsigned int mv = (data * 1000UL) / 1024UL;
+    mv = ((data * 5000UL)>>10);
+    
+    // Hand over to (lower priority) output task
+    task_post(TASK_OUTPUT, EVENT_SEND);
+}
+
+// Output task: Sends the voltage status over UART
+void output_task(unsigned char events)
+{
+    printf("Voltage: %4u mV\r", mv);
+}
 
 int main(void)
 {
@@ -79,31 +130,15 @@ int main(void)
     // Select ADC channel 5 (unipolar mode)
     adc_channel(ADC_CH5);
     
-    while (1) 
-    {
-        // Read data from A/D channel 5 and
-        // adjust it right
-        unsigned int data = (adc_read()>>6);
-        
-        // Write converted value to PORT
-        // PORT only has 8 Bit, so 2 bits
-        // have to be thrown away!
-        PORTC = (unsigned char)(data>>2);
-        
-        // Calculation the Voltage in mV on ADC channel(5)
-        //
-        //                5000 mV
-        // U_mV = data * --------- 
-        //                 2^10
-        //
-        // Better (faster) option for dividing /1024 is shifting 10 bits right (2^10)
-        // unsigned int mv = (data * 1000UL) / 1024UL;
-        unsigned int mv = ((data * 5000UL)>>10);
-        
-        // Send Voltage status over UART
-        printf("Voltage: %4u mV\r", mv);
-        
-        // Slows down the reloading of Console
-        _delay_ms(100);
-    }
+    // Initialize system tick (1 ms) with defined parameters in tick.h
+    tick_init();
+    
+    task_create(TASK_MEASURE, measure_task);
+    task_create(TASK_OUTPUT, output_task);
+    
+    // Sample every 100 ms (replaces _delay_ms)
+    tick_timer_start(100, TICK_Periodic, sample_timer);
+    
+    // Execute tasks, CPU sleeps (idle) while no task is ready
+    task_run();
 }
\ No newline at end of file
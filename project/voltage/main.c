@@ -58,25 +58,23 @@
 #include "../../library/lcd/lcd.h"
 #include "../../library/adc/adc.h"
 
+// Ohm character (stored in flash, loaded to CGRAM by glyph manager)
+const unsigned char pattern_ohm[] PROGMEM = {
+                                                0b00000,
+                                                0b00000,
+                                                0b01110,
+                                                0b10001,
+                                                0b10001,
+                                                0b01010,
+                                                0b01010,
+                                                0b11011
+                                            };
+
 int main(void)
 {
     // Initialize LCD with defined parameters in lcd.h
     lcd_init();
     
-    // Ohm character
-    unsigned char pattern_ohm[] =   {
-                                        0b00000,
-                                        0b00000,
-                                        0b01110,
-                                        0b10001,
-                                        0b10001,
-                                        0b01010,
-                                        0b01010,
-                                        0b11011
-                                    };
-    
-    lcd_pattern(LCD_CGADDR_CHAR0, pattern_ohm);
-    
     // Initialize ADC with defined parameters in adc.h
     adc_init();
     
@@ -138,6 +136,6 @@ int main(void)
         // Write R=????Ohm to display
         lcd_string("R=");
         lcd_ul2ascii(r2, LCD_Decimal, 4);
-        lcd_char(LCD_CGADDR_CHAR0);
+        lcd_char(lcd_glyph(pattern_ohm));   // Pattern is only transferred if not resident
     }
 }
\ No newline at end of file